@@ -0,0 +1,47 @@
+// atomic_ops.hpp - lock-free read-modify-write helpers built on compare-and-swap.
+//
+//   fetch_min_cas(a, v)      a = min(a, v), returns the previous value
+//   fetch_max_cas(a, v)      a = max(a, v), returns the previous value
+//   fetch_update_cas(a, f)   a = f(a) for any pure function f, returns the previous value
+//
+// All three load first and skip the CAS entirely when the update would not change the value
+// (v is not better, or f(a) == a). For a running min/max over random data almost every element
+// takes that exit, so the shared cache line stays in the Shared state on every core instead of
+// bouncing between them the way a critical section's lock does.
+//
+// The _cas names keep clear of C++26 std::atomic_fetch_min/max, which an unqualified call on a
+// std::atomic would otherwise also find through ADL.
+#ifndef ATOMIC_OPS_HPP
+#define ATOMIC_OPS_HPP
+
+#include <atomic>
+
+template <typename T>
+T fetch_min_cas(std::atomic<T> &a, T v, std::memory_order order = std::memory_order_relaxed) {
+    T cur = a.load(std::memory_order_relaxed);
+    // On failure compare_exchange_weak reloads cur, so the loop re-checks against the new value
+    while (v < cur && !a.compare_exchange_weak(cur, v, order, std::memory_order_relaxed)) {
+    }
+    return cur;
+}
+
+template <typename T>
+T fetch_max_cas(std::atomic<T> &a, T v, std::memory_order order = std::memory_order_relaxed) {
+    T cur = a.load(std::memory_order_relaxed);
+    while (cur < v && !a.compare_exchange_weak(cur, v, order, std::memory_order_relaxed)) {
+    }
+    return cur;
+}
+
+// f is called with the current value and may be retried, so it must have no side effects.
+template <typename T, typename F>
+T fetch_update_cas(std::atomic<T> &a, F f, std::memory_order order = std::memory_order_relaxed) {
+    T cur = a.load(std::memory_order_relaxed);
+    for (;;) {
+        T next = f(cur);
+        if (next == cur) return cur;
+        if (a.compare_exchange_weak(cur, next, order, std::memory_order_relaxed)) return cur;
+    }
+}
+
+#endif // ATOMIC_OPS_HPP
@@ -1,110 +1,1499 @@
+#ifdef __linux__
+#define _GNU_SOURCE // sched_setaffinity, CPU_SET
+#endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
 #include <omp.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#define HAVE_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
-// Define the matrix size. N=500 is used to ensure a measurable time difference.
-#define N 500
+// Default problem size (M = K = N = 500) when no sizes are given on the command line.
+#define N_DEFAULT 500
 
-// Matrices must be declared globally (or statically) for large N to avoid stack overflow.
-int A[N][N];
-int B[N][N];
-int C_seq[N][N];
-int C_par[N][N];
+// Sweep mode: default size range, and the largest size for which the naive O(N^3)
+// baseline is still run (beyond that it takes minutes and only the engine is timed).
+#define SWEEP_MIN 64
+#define SWEEP_MAX 4096
+#define SWEEP_NAIVE_MAX 1024
 
-int main() {
+// Recursive (omp task) multiply: sub-problems at or below REC_CUTOFF in every dimension use
+// the serial blocked kernel; STRASSEN_MIN is the smallest dimension that takes a Strassen
+// step (0 disables Strassen). Both can be changed with --cutoff / --strassen.
+#define REC_CUTOFF 256
+#define STRASSEN_MIN 2048
+
+// Freivalds verification: independent random rounds per check. A wrong C slips through
+// one round with probability at most 1/2, so all rounds with at most 2^-FREIVALDS_ROUNDS.
+#define FREIVALDS_ROUNDS 10
+
+// Cache-blocking parameters for the tiled engine.
+// An MC x KC block of A stays in L2 while a KC x NR packed panel of B streams through L1;
+// each MC x NC tile of C is owned by exactly one thread, so no reduction is needed.
+#define MC 96
+#define NC 128 // must be a multiple of NR so tiles start on panel boundaries
+#define KC 256
+// Register tile: every micro-kernel call keeps an MR x NR block of C in registers.
+#define MR 6
+#define NR 16
+
+// Element-type-agnostic pieces: int and float are both 4-byte words, so packing and the
+// tile bookkeeping move raw 32-bit words around and only the kernels know the arithmetic.
+typedef uint32_t Word;
+
+// A tile kernel computes C[0..MR)[0..nr) += A[0..MR)[0..kc) * Bp[0..kc)[0..NR).
+// Bp is a packed panel (row stride NR); padded columns beyond nr are computed but not stored.
+typedef void (*TileKernel)(int nr, int kc, const void *A, int lda, const void *Bp, void *C, int ldc);
+
+// --- Packing: copy B (k x n) into NR-wide column panels, zero-padded to a multiple of NR ---
+// Panel p holds columns [p*NR, p*NR+NR) as k consecutive rows of NR words, so the micro-kernel
+// reads B with unit stride instead of jumping ldb words per k. Done once per multiply.
+// Works for int and float alike (all-zero bits is 0 in both).
+static void packPanel(int k, int n, const void *B, int ldb, Word *Bp, int p) {
+    int j0 = p * NR;
+    int nr = j0 + NR < n ? NR : n - j0;
+    Word *dst = Bp + (long)p * k * NR;
+    for (int kk = 0; kk < k; kk++) {
+        memcpy(dst + (long)kk * NR, (const Word*)B + (long)kk * ldb + j0, nr * sizeof(Word));
+        memset(dst + (long)kk * NR + nr, 0, (NR - nr) * sizeof(Word));
+    }
+}
+
+void *packB(int k, int n, const void *B, int ldb) {
+    int panels = (n + NR - 1) / NR;
+    Word *Bp = (Word*)aligned_alloc(64, (size_t)panels * k * NR * sizeof(Word));
+    if (!Bp) return NULL;
+
+    #pragma omp parallel for schedule(static)
+    for (int p = 0; p < panels; p++) {
+        packPanel(k, n, B, ldb, Bp, p);
+    }
+    return Bp;
+}
+
+// --- Scalar kernels (portable fallback) ---
+// The accumulators live in a local array the compiler can keep in (vector) registers.
+static void tileScalarI32(int nr, int kc, const void *A_, int lda, const void *Bp_, void *C_, int ldc) {
+    const int *A = A_, *Bp = Bp_;
+    int *C = C_;
+    int acc[MR][NR] = {{0}};
+
+    for (int k = 0; k < kc; k++) {
+        const int *b = Bp + (long)k * NR;
+        for (int r = 0; r < MR; r++) {
+            int a = A[(long)r * lda + k];
+            for (int c = 0; c < NR; c++) {
+                acc[r][c] += a * b[c];
+            }
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        for (int c = 0; c < nr; c++) {
+            C[(long)r * ldc + c] += acc[r][c];
+        }
+    }
+}
+
+static void tileScalarF32(int nr, int kc, const void *A_, int lda, const void *Bp_, void *C_, int ldc) {
+    const float *A = A_, *Bp = Bp_;
+    float *C = C_;
+    float acc[MR][NR] = {{0}};
+
+    for (int k = 0; k < kc; k++) {
+        const float *b = Bp + (long)k * NR;
+        for (int r = 0; r < MR; r++) {
+            float a = A[(long)r * lda + k];
+            for (int c = 0; c < NR; c++) {
+                acc[r][c] += a * b[c];
+            }
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        for (int c = 0; c < nr; c++) {
+            C[(long)r * ldc + c] += acc[r][c];
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// --- AVX2 kernels: each row of the MR x NR tile is two 8-lane registers (12 accumulators) ---
+// Compiled for AVX2 via target attributes so the rest of the program stays baseline x86-64;
+// they are only ever called after selectKernels() has checked CPUID.
+__attribute__((target("avx2")))
+static void tileAvx2I32(int nr, int kc, const void *A_, int lda, const void *Bp_, void *C_, int ldc) {
+    const int *A = A_, *Bp = Bp_;
+    int *C = C_;
+    __m256i acc[MR][2];
+    for (int r = 0; r < MR; r++) { acc[r][0] = acc[r][1] = _mm256_setzero_si256(); }
+
+    for (int k = 0; k < kc; k++) {
+        __m256i b0 = _mm256_load_si256((const __m256i*)(Bp + (long)k * NR));
+        __m256i b1 = _mm256_load_si256((const __m256i*)(Bp + (long)k * NR + 8));
+        for (int r = 0; r < MR; r++) {
+            __m256i a = _mm256_set1_epi32(A[(long)r * lda + k]);
+            acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_mullo_epi32(a, b0));
+            acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_mullo_epi32(a, b1));
+        }
+    }
+
+    int tmp[MR][NR];
+    for (int r = 0; r < MR; r++) {
+        _mm256_storeu_si256((__m256i*)&tmp[r][0], acc[r][0]);
+        _mm256_storeu_si256((__m256i*)&tmp[r][8], acc[r][1]);
+        for (int c = 0; c < nr; c++) { C[(long)r * ldc + c] += tmp[r][c]; }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void tileAvx2F32(int nr, int kc, const void *A_, int lda, const void *Bp_, void *C_, int ldc) {
+    const float *A = A_, *Bp = Bp_;
+    float *C = C_;
+    __m256 acc[MR][2];
+    for (int r = 0; r < MR; r++) { acc[r][0] = acc[r][1] = _mm256_setzero_ps(); }
+
+    for (int k = 0; k < kc; k++) {
+        __m256 b0 = _mm256_load_ps(Bp + (long)k * NR);
+        __m256 b1 = _mm256_load_ps(Bp + (long)k * NR + 8);
+        for (int r = 0; r < MR; r++) {
+            __m256 a = _mm256_set1_ps(A[(long)r * lda + k]);
+            acc[r][0] = _mm256_fmadd_ps(a, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(a, b1, acc[r][1]);
+        }
+    }
+
+    float tmp[MR][NR];
+    for (int r = 0; r < MR; r++) {
+        _mm256_storeu_ps(&tmp[r][0], acc[r][0]);
+        _mm256_storeu_ps(&tmp[r][8], acc[r][1]);
+        for (int c = 0; c < nr; c++) { C[(long)r * ldc + c] += tmp[r][c]; }
+    }
+}
+
+// --- AVX-512 kernels: each row of the tile is a single 16-lane register ---
+__attribute__((target("avx512f")))
+static void tileAvx512I32(int nr, int kc, const void *A_, int lda, const void *Bp_, void *C_, int ldc) {
+    const int *A = A_, *Bp = Bp_;
+    int *C = C_;
+    __m512i acc[MR];
+    for (int r = 0; r < MR; r++) { acc[r] = _mm512_setzero_si512(); }
+
+    for (int k = 0; k < kc; k++) {
+        __m512i b = _mm512_load_si512(Bp + (long)k * NR);
+        for (int r = 0; r < MR; r++) {
+            __m512i a = _mm512_set1_epi32(A[(long)r * lda + k]);
+            acc[r] = _mm512_add_epi32(acc[r], _mm512_mullo_epi32(a, b));
+        }
+    }
+
+    __mmask16 mask = (__mmask16)((1u << nr) - 1);
+    for (int r = 0; r < MR; r++) {
+        int *c = C + (long)r * ldc;
+        _mm512_mask_storeu_epi32(c, mask, _mm512_add_epi32(_mm512_maskz_loadu_epi32(mask, c), acc[r]));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void tileAvx512F32(int nr, int kc, const void *A_, int lda, const void *Bp_, void *C_, int ldc) {
+    const float *A = A_, *Bp = Bp_;
+    float *C = C_;
+    __m512 acc[MR];
+    for (int r = 0; r < MR; r++) { acc[r] = _mm512_setzero_ps(); }
+
+    for (int k = 0; k < kc; k++) {
+        __m512 b = _mm512_load_ps(Bp + (long)k * NR);
+        for (int r = 0; r < MR; r++) {
+            acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(A[(long)r * lda + k]), b, acc[r]);
+        }
+    }
+
+    __mmask16 mask = (__mmask16)((1u << nr) - 1);
+    for (int r = 0; r < MR; r++) {
+        float *c = C + (long)r * ldc;
+        _mm512_mask_storeu_ps(c, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, c), acc[r]));
+    }
+}
+#endif
+
+// --- Kernel dispatch ---
+// One binary carries every kernel; selectKernels() picks the widest one this CPU supports.
+typedef struct {
+    const char *name;
+    TileKernel i32;
+    TileKernel f32;
+} KernelSet;
+
+static const KernelSet kernel_sets[] = {
+    {"scalar", tileScalarI32, tileScalarF32},
+#if defined(__x86_64__) || defined(__i386__)
+    {"avx2", tileAvx2I32, tileAvx2F32},
+    {"avx512", tileAvx512I32, tileAvx512F32},
+#endif
+};
+#define N_KERNEL_SETS ((int)(sizeof(kernel_sets) / sizeof(kernel_sets[0])))
+
+static const KernelSet *active_kernels = &kernel_sets[0];
+
+int kernelSupported(const KernelSet *ks) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (strcmp(ks->name, "avx2") == 0) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    if (strcmp(ks->name, "avx512") == 0) {
+        return __builtin_cpu_supports("avx512f");
+    }
+#endif
+    return strcmp(ks->name, "scalar") == 0;
+}
+
+const KernelSet *selectKernels(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+#endif
+    for (int s = N_KERNEL_SETS - 1; s >= 0; s--) {
+        if (kernelSupported(&kernel_sets[s])) {
+            active_kernels = &kernel_sets[s];
+            break;
+        }
+    }
+    return active_kernels;
+}
+
+// --- One block of C: C[i0..i1)[j0..j1) += A[i0..i1)[0..k) * B[0..k)[j0..j1) ---
+// The k dimension is walked in KC steps and the block is swept by MR x NR register tiles.
+// j0 must be a multiple of NR (tiles start on panel boundaries). A last row strip with fewer
+// than MR rows is copied into a zero-padded MR-row buffer, and its C rows into a scratch tile,
+// so it still runs on the vector kernel (this matters when a whole multiply is only a few rows).
+static void gemmBlock(int i0, int i1, int j0, int j1, int k, const Word *A, int lda, const Word *Bp,
+                      Word *C, int ldc, TileKernel tile) {
+    Word a_pad[MR * KC];
+    Word c_pad[MR * NR];
+
+    for (int p0 = 0; p0 < k; p0 += KC) {
+        int kc = p0 + KC < k ? KC : k - p0;
+
+        for (int i = i0; i < i1; i += MR) {
+            int mr = i + MR < i1 ? MR : i1 - i;
+            const Word *a = A + (long)i * lda + p0;
+            int a_ld = lda;
+            if (mr < MR) {
+                memset(a_pad, 0, sizeof(a_pad));
+                for (int r = 0; r < mr; r++) memcpy(a_pad + r * KC, a + (long)r * lda, kc * sizeof(Word));
+                a = a_pad;
+                a_ld = KC;
+            }
+
+            for (int j = j0; j < j1; j += NR) {
+                int nr = j + NR < j1 ? NR : j1 - j;
+                const Word *b = Bp + (long)(j / NR) * k * NR + (long)p0 * NR;
+                Word *c = C + (long)i * ldc + j;
+
+                if (mr == MR) {
+                    tile(nr, kc, a, a_ld, b, c, ldc);
+                } else {
+                    memset(c_pad, 0, sizeof(c_pad));
+                    for (int r = 0; r < mr; r++) memcpy(c_pad + r * NR, c + (long)r * ldc, nr * sizeof(Word));
+                    tile(nr, kc, a, a_ld, b, c_pad, NR);
+                    for (int r = 0; r < mr; r++) memcpy(c + (long)r * ldc, c_pad + r * NR, nr * sizeof(Word));
+                }
+            }
+        }
+    }
+}
+
+// --- Blocked GEMM driver: C (m x n) = A (m x k) * B (k x n), A and C row-major, B packed by packB ---
+// One parallel region distributes the MC x NC tiles of C over the team; each tile is
+// cleared and then accumulated by gemmBlock on the thread that owns it.
+// With accumulate set, C += A * B (the tiles are not cleared first).
+static void gemmTiles(int m, int n, int k, const Word *A, int lda, const Word *Bp, Word *C, int ldc,
+                      TileKernel tile, int accumulate) {
+    int tiles_m = (m + MC - 1) / MC;
+    int tiles_n = (n + NC - 1) / NC;
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int ti = 0; ti < tiles_m; ti++) {
+        for (int tj = 0; tj < tiles_n; tj++) {
+            int i0 = ti * MC, i1 = i0 + MC < m ? i0 + MC : m;
+            int j0 = tj * NC, j1 = j0 + NC < n ? j0 + NC : n;
+
+            for (int i = i0; i < i1 && !accumulate; i++) {
+                memset(C + (long)i * ldc + j0, 0, (j1 - j0) * sizeof(Word));
+            }
+            gemmBlock(i0, i1, j0, j1, k, A, lda, Bp, C, ldc, tile);
+        }
+    }
+}
+
+void gemmPacked(int m, int n, int k, const int *A, int lda, const int *Bp, int *C, int ldc) {
+    gemmTiles(m, n, k, (const Word*)A, lda, (const Word*)Bp, (Word*)C, ldc, active_kernels->i32, 0);
+}
+
+void gemmPackedF(int m, int n, int k, const float *A, int lda, const float *Bp, float *C, int ldc) {
+    gemmTiles(m, n, k, (const Word*)A, lda, (const Word*)Bp, (Word*)C, ldc, active_kernels->f32, 0);
+}
+
+// =========================================================
+// Task-parallel recursive multiply (divide and conquer, optional Strassen)
+// =========================================================
+// Sub-problems below rec_cutoff in every dimension go to the serial blocked kernel; larger ones
+// are halved along their largest dimension, M and N halves as independent omp tasks and K halves
+// one after the other (both accumulate into the same C). Square-ish problems whose dimensions
+// are all even and at least strassen_min take one Strassen step (7 products instead of 8).
+int rec_cutoff = REC_CUTOFF;
+int strassen_min = STRASSEN_MIN;
+
+// Serial base case: C += A * B with a private packed copy of B.
+static void gemmBase(int m, int n, int k, const int *A, int lda, const int *B, int ldb, int *C, int ldc) {
+    int panels = (n + NR - 1) / NR;
+    Word *Bp = (Word*)aligned_alloc(64, (size_t)panels * k * NR * sizeof(Word));
+    if (!Bp) {
+        perror("Failed to allocate packed B");
+        exit(1);
+    }
+    for (int p = 0; p < panels; p++) {
+        packPanel(k, n, B, ldb, Bp, p);
+    }
+    gemmBlock(0, m, 0, n, k, (const Word*)A, lda, Bp, (Word*)C, ldc, active_kernels->i32);
+    free(Bp);
+}
+
+// Z (rows x cols) = X + sign * Y
+static void matAdd(int rows, int cols, const int *X, int ldx, const int *Y, int ldy, int sign, int *Z, int ldz) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            Z[(long)i * ldz + j] = X[(long)i * ldx + j] + sign * Y[(long)i * ldy + j];
+        }
+    }
+}
+
+static void gemmRec(int m, int n, int k, const int *A, int lda, const int *B, int ldb, int *C, int ldc);
+
+// One Strassen step: C += A * B for even m, n, k. All seven products run as tasks.
+static void strassenStep(int m, int n, int k, const int *A, int lda, const int *B, int ldb, int *C, int ldc) {
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    const int *A11 = A, *A12 = A + hk, *A21 = A + (long)hm * lda, *A22 = A21 + hk;
+    const int *B11 = B, *B12 = B + hn, *B21 = B + (long)hk * ldb, *B22 = B21 + hn;
+    int *C11 = C, *C12 = C + hn, *C21 = C + (long)hm * ldc, *C22 = C21 + hn;
+
+    // M1..M7 are hm x hn, zero-initialized because gemmRec accumulates.
+    int *M[7];
+    for (int q = 0; q < 7; q++) {
+        M[q] = calloc((size_t)hm * hn, sizeof(int));
+        if (!M[q]) {
+            perror("Failed to allocate Strassen temporaries");
+            exit(1);
+        }
+    }
+
+    // Operand pairs (sign 0 means "use X as is"): M = (X1 + s1*Y1) * (X2 + s2*Y2)
+    struct { const int *X1, *Y1; int s1; const int *X2, *Y2; int s2; } ops[7] = {
+        {A11, A22, +1, B11, B22, +1},
+        {A21, A22, +1, B11, NULL, 0},
+        {A11, NULL, 0, B12, B22, -1},
+        {A22, NULL, 0, B21, B11, -1},
+        {A11, A12, +1, B22, NULL, 0},
+        {A21, A11, -1, B11, B12, +1},
+        {A12, A22, -1, B21, B22, +1},
+    };
+
+    for (int q = 0; q < 7; q++) {
+        #pragma omp task firstprivate(q) shared(ops, M)
+        {
+            const int *L = ops[q].X1, *R = ops[q].X2;
+            int ldl = lda, ldr = ldb;
+            int *Ls = NULL, *Rs = NULL;
+            if (ops[q].Y1) {
+                Ls = malloc((size_t)hm * hk * sizeof(int));
+                if (!Ls) { perror("Failed to allocate Strassen temporaries"); exit(1); }
+                matAdd(hm, hk, ops[q].X1, lda, ops[q].Y1, lda, ops[q].s1, Ls, hk);
+                L = Ls; ldl = hk;
+            }
+            if (ops[q].Y2) {
+                Rs = malloc((size_t)hk * hn * sizeof(int));
+                if (!Rs) { perror("Failed to allocate Strassen temporaries"); exit(1); }
+                matAdd(hk, hn, ops[q].X2, ldb, ops[q].Y2, ldb, ops[q].s2, Rs, hn);
+                R = Rs; ldr = hn;
+            }
+            gemmRec(hm, hn, hk, L, ldl, R, ldr, M[q], hn);
+            free(Ls); free(Rs);
+        }
+    }
+    #pragma omp taskwait
+
+    // C11 += M1 + M4 - M5 + M7,  C12 += M3 + M5,  C21 += M2 + M4,  C22 += M1 - M2 + M3 + M6
+    for (int i = 0; i < hm; i++) {
+        for (int j = 0; j < hn; j++) {
+            long q = (long)i * hn + j;
+            C11[(long)i * ldc + j] += M[0][q] + M[3][q] - M[4][q] + M[6][q];
+            C12[(long)i * ldc + j] += M[2][q] + M[4][q];
+            C21[(long)i * ldc + j] += M[1][q] + M[3][q];
+            C22[(long)i * ldc + j] += M[0][q] - M[1][q] + M[2][q] + M[5][q];
+        }
+    }
+    for (int q = 0; q < 7; q++) free(M[q]);
+}
+
+// C += A * B, recursively. Must be called from inside a parallel region (see gemmRecursive).
+static void gemmRec(int m, int n, int k, const int *A, int lda, const int *B, int ldb, int *C, int ldc) {
+    if (m <= rec_cutoff && n <= rec_cutoff && k <= rec_cutoff) {
+        gemmBase(m, n, k, A, lda, B, ldb, C, ldc);
+        return;
+    }
+
+    int min_dim = m < n ? (m < k ? m : k) : (n < k ? n : k);
+    if (strassen_min > 0 && min_dim >= strassen_min && m % 2 == 0 && n % 2 == 0 && k % 2 == 0) {
+        strassenStep(m, n, k, A, lda, B, ldb, C, ldc);
+        return;
+    }
+
+    if (m >= n && m >= k) {
+        // Split rows of A and C: the halves write disjoint parts of C.
+        int h = m / 2;
+        #pragma omp task
+        gemmRec(h, n, k, A, lda, B, ldb, C, ldc);
+        gemmRec(m - h, n, k, A + (long)h * lda, lda, B, ldb, C + (long)h * ldc, ldc);
+        #pragma omp taskwait
+    } else if (n >= k) {
+        // Split columns of B and C; keep the split on a panel boundary.
+        int h = (n / 2 + NR - 1) / NR * NR;
+        if (h >= n) h = n / 2;
+        #pragma omp task
+        gemmRec(m, h, k, A, lda, B, ldb, C, ldc);
+        gemmRec(m, n - h, k, A, lda, B + h, ldb, C + h, ldc);
+        #pragma omp taskwait
+    } else {
+        // Split the shared dimension: both halves add into the same C, so run them in turn.
+        int h = k / 2;
+        gemmRec(m, n, h, A, lda, B, ldb, C, ldc);
+        gemmRec(m, n, k - h, A + h, lda, B + (long)h * ldb, ldb, C, ldc);
+    }
+}
+
+// C (m x n) = A (m x k) * B (k x n), row-major with tight leading dimensions.
+void gemmRecursive(int m, int n, int k, const int *A, const int *B, int *C) {
+    memset(C, 0, (size_t)m * n * sizeof(int));
+    #pragma omp parallel
+    #pragma omp single
+    gemmRec(m, n, k, A, k, B, n, C, n);
+}
+
+// =========================================================
+// NUMA placement
+// =========================================================
+// Linux puts a page on the NUMA node of the thread that first writes it. The matrices are
+// therefore allocated untouched and initialized in parallel with the same collapse(2) static
+// schedule over MC x NC tiles that gemmTiles uses, so a thread's tiles of C and its slice of
+// A's row band land on its own node. With --interleave the pages are spread round-robin over
+// all nodes instead (better when the thread count does not match the init run).
+#define MPOL_INTERLEAVE_MODE 3 // MPOL_INTERLEAVE from <numaif.h>, used via the raw syscall
+
+int interleave_pages = 0;
+
+// Page size of this machine (4 KiB on x86, 16 or 64 KiB on some arm64/ppc64 kernels): the
+// unit of placement for mbind/move_pages and of alignment for msync/madvise.
+long pageBytes(void) {
+    static long page = 0;
+    if (page == 0) {
+        long p = 0;
+#if defined(__linux__) || defined(HAVE_MMAP)
+        p = sysconf(_SC_PAGESIZE);
+#endif
+        page = p > 0 ? p : 4096;
+    }
+    return page;
+}
+
+// Number of NUMA nodes (1 on non-NUMA systems or non-Linux hosts).
+int numaNodes(void) {
+    static int nodes = 0;
+    if (nodes == 0) {
+        nodes = 1;
+#ifdef __linux__
+        char path[64];
+        for (int nd = 1; nd < 1024; nd++) {
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", nd);
+            if (access(path, F_OK) != 0) break;
+            nodes = nd + 1;
+        }
+#endif
+    }
+    return nodes;
+}
+
+// NUMA node of the calling thread's current CPU.
+int currentNode(void) {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) return (int)node;
+#endif
+    return 0;
+}
+
+// Pin each thread of the next parallel regions to its own CPU, spread evenly over the CPUs
+// this process may use. Skipped when the user already chose a binding via OMP_PROC_BIND.
+// The allowed set is captured on the first call, before anything is pinned: afterwards the
+// master thread's own mask is just cpus[0], and re-reading it would put every thread there.
+void placeThreads(void) {
+#ifdef __linux__
+    if (omp_get_proc_bind() != omp_proc_bind_false) return;
+
+    static cpu_set_t allowed;
+    static int allowed_state = 0; // 0 = not read yet, 1 = valid, -1 = unavailable
+    if (allowed_state == 0) {
+        allowed_state = sched_getaffinity(0, sizeof(allowed), &allowed) == 0 ? 1 : -1;
+    }
+    if (allowed_state != 1) return;
+    int cpus[CPU_SETSIZE], n_cpus = 0;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &allowed)) cpus[n_cpus++] = c;
+    }
+
+    #pragma omp parallel
+    {
+        int t = omp_get_thread_num(), team = omp_get_num_threads();
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpus[(long)t * n_cpus / team], &one);
+        sched_setaffinity(0, sizeof(one), &one);
+    }
+#endif
+}
+
+// --- Aligned heap matrix (rows x cols words) ---
+// Page aligned so placement policies apply to whole pages (and rows and packed panels start
+// on cache-line boundaries). The pages are left untouched: the first write decides the node.
+void *allocMatrix(long rows, long cols) {
+    size_t page = (size_t)pageBytes();
+    size_t bytes = (size_t)rows * cols * sizeof(Word);
+    bytes = (bytes + page - 1) / page * page;
+    if (bytes == 0) bytes = page;
+    void *ptr = aligned_alloc(page, bytes);
+
+#if defined(__linux__) && defined(SYS_mbind)
+    if (ptr && interleave_pages && numaNodes() > 1) {
+        const int bits = 8 * sizeof(unsigned long);
+        unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {0};
+        for (int nd = 0; nd < numaNodes(); nd++) mask[nd / bits] |= 1UL << (nd % bits);
+        if (syscall(SYS_mbind, ptr, bytes, MPOL_INTERLEAVE_MODE, mask, 1024UL, 0) != 0) {
+            perror("mbind(MPOL_INTERLEAVE)");
+        }
+    }
+#endif
+    return ptr;
+}
+
+// --- Test data: values stay in 1..16 ---
+// Every partial sum is then at most 256 * K, an integer that float represents exactly for
+// K < 65536, so the float kernels can be checked bit-exact against the int baseline.
+// A (and C, when given) are first-touched tile by tile exactly as gemmTiles walks them.
+void initMatrices(int m, int n, int k, int *A, int *B, int *C) {
+    int tiles_m = (m + MC - 1) / MC;
+    int tiles_n = (n + NC - 1) / NC;
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int ti = 0; ti < tiles_m; ti++) {
+        for (int tj = 0; tj < tiles_n; tj++) {
+            int i0 = ti * MC, i1 = i0 + MC < m ? i0 + MC : m;
+            int j0 = tj * NC, j1 = j0 + NC < n ? j0 + NC : n;
+            // The owner of tile (ti, tj) touches its share of A's row band ti.
+            long p0 = (long)k * tj / tiles_n, p1 = (long)k * (tj + 1) / tiles_n;
+
+            for (int i = i0; i < i1; i++) {
+                for (long p = p0; p < p1; p++) { A[(long)i * k + p] = i % 16 + 1; }
+                if (C) {
+                    for (int j = j0; j < j1; j++) { C[(long)i * n + j] = 0; }
+                }
+            }
+        }
+    }
+
+    // B is read by every thread (through packB), so a plain static row split is as good as any.
+    #pragma omp parallel for schedule(static)
+    for (int p = 0; p < k; p++) {
+        for (int j = 0; j < n; j++) { B[(long)p * n + j] = j % 16 + 1; }
+    }
+}
+
+// --- Placement report: where A's pages live, and read bandwidth per node ---
+// Each thread streams the rows it owns (same static row split as the init) and records its
+// node, bytes and time; the per-node bandwidth is bytes over the slowest thread on that node.
+void reportPlacement(int m, int k, const int *A) {
+    int nodes = numaNodes();
+    if (nodes > 64) nodes = 64;
+    long pages_on[64] = {0};
+    double bytes_on[64] = {0}, time_on[64] = {0};
+    int threads_on[64] = {0};
+    long checksum = 0; // printed nowhere, only keeps the read loop from being optimized away
+
+#if defined(__linux__) && defined(SYS_move_pages)
+    // move_pages with no target nodes only reports the node of each page.
+    long page = pageBytes();
+    long n_pages = ((long)m * k * (long)sizeof(int) + page - 1) / page;
+    long stride = n_pages > 4096 ? n_pages / 4096 : 1;
+    long samples = (n_pages + stride - 1) / stride;
+    void **pages = malloc(samples * sizeof(void*));
+    int *status = malloc(samples * sizeof(int));
+    if (pages && status) {
+        for (long q = 0; q < samples; q++) pages[q] = (char*)A + q * stride * page;
+        if (syscall(SYS_move_pages, 0, samples, pages, NULL, status, 0) == 0) {
+            for (long q = 0; q < samples; q++) {
+                if (status[q] >= 0 && status[q] < nodes) pages_on[status[q]]++;
+            }
+        }
+    }
+    free(pages); free(status);
+#endif
+
+    #pragma omp parallel
+    {
+        int t = omp_get_thread_num(), team = omp_get_num_threads();
+        long i0 = (long)m * t / team, i1 = (long)m * (t + 1) / team;
+        int node = currentNode();
+        if (node >= nodes) node = 0;
+
+        double start = omp_get_wtime();
+        long sum = 0;
+        for (int rep = 0; rep < 4; rep++) {
+            for (long idx = i0 * k; idx < i1 * k; idx++) sum += A[idx];
+        }
+        double elapsed = omp_get_wtime() - start;
+
+        #pragma omp critical
+        {
+            checksum += sum;
+            bytes_on[node] += 4.0 * (i1 - i0) * k * sizeof(int);
+            if (elapsed > time_on[node]) time_on[node] = elapsed;
+            threads_on[node]++;
+        }
+    }
+
+    (void)checksum;
+    printf("   Memory placement (%s, %d node%s):\n", interleave_pages ? "interleaved" : "parallel first touch",
+           nodes, nodes > 1 ? "s" : "");
+    long total_pages = 0;
+    for (int nd = 0; nd < nodes; nd++) total_pages += pages_on[nd];
+    for (int nd = 0; nd < nodes; nd++) {
+        printf("     Node %d: %5.1f%% of A's pages, %2d threads, read bandwidth %.2f GB/s\n", nd,
+               total_pages ? 100.0 * pages_on[nd] / total_pages : 0.0, threads_on[nd],
+               time_on[nd] > 0 ? bytes_on[nd] / time_on[nd] * 1e-9 : 0.0);
+    }
+}
+
+// --- Naive sequential triple loop (the baseline every engine is checked against) ---
+void gemmNaive(int m, int n, int k, const int *A, const int *B, int *C) {
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            int sum = 0;
+            for (int p = 0; p < k; p++) {
+                sum += A[(long)i * k + p] * B[(long)p * n + j];
+            }
+            C[(long)i * n + j] = sum;
+        }
+    }
+}
+
+double gflops(int m, int n, int k, double seconds) {
+    return 2.0 * m * n * k / seconds * 1e-9;
+}
+
+// --- Pack + multiply with the selected kernels; returns total time, pack time via *pack_time ---
+double timedGemm(int m, int n, int k, const int *A, const int *B, int *C, double *pack_time) {
+    double start_time = omp_get_wtime();
+    int *Bp = packB(k, n, B, n);
+    double packed_time = omp_get_wtime();
+    if (!Bp) {
+        perror("Failed to allocate packed B");
+        exit(1);
+    }
+    gemmPacked(m, n, k, A, k, Bp, C, n);
+    double end_time = omp_get_wtime();
+    free(Bp);
+    if (pack_time) *pack_time = packed_time - start_time;
+    return end_time - start_time;
+}
+
+// --- Freivalds check: does C == A * B hold? (A is m x k, B is k x n, C is m x n) ---
+// Each round draws a random vector r and compares A * (B * r) with C * r: three O(N^2)
+// matrix-vector products instead of an O(N^3) reference multiply. Arithmetic is done modulo
+// 2^32, matching the wrap-around of the int kernels, so overflowed results still verify.
+// Returns the number of rounds that detected a mismatch (0 = verified).
+int freivalds(int m, int n, int k, const int *A, const int *B, const int *C, int rounds, unsigned seed) {
+    uint32_t *r = malloc((size_t)n * sizeof(uint32_t));
+    uint32_t *br = malloc((size_t)k * sizeof(uint32_t));
+    if (!r || !br) {
+        perror("Failed to allocate Freivalds vectors");
+        exit(1);
+    }
+
+    int failed = 0;
+    for (int round = 0; round < rounds; round++) {
+        // xorshift32 stream per round, so the check is reproducible for a given seed.
+        uint32_t x = seed * 2654435761u + (uint32_t)round * 40503u + 1u;
+        for (int j = 0; j < n; j++) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            r[j] = x;
+        }
+
+        #pragma omp parallel for schedule(static)
+        for (int p = 0; p < k; p++) {
+            uint32_t sum = 0;
+            for (int j = 0; j < n; j++) sum += (uint32_t)B[(long)p * n + j] * r[j];
+            br[p] = sum;
+        }
+
+        int diff = 0;
+        #pragma omp parallel for schedule(static) reduction(|:diff)
+        for (int i = 0; i < m; i++) {
+            uint32_t abr = 0, cr = 0;
+            for (int p = 0; p < k; p++) abr += (uint32_t)A[(long)i * k + p] * br[p];
+            for (int j = 0; j < n; j++) cr += (uint32_t)C[(long)i * n + j] * r[j];
+            diff |= abr != cr;
+        }
+        failed += diff;
+    }
+
+    free(r); free(br);
+    return failed;
+}
+
+// =========================================================
+// Single-shape test: C (M x N) = A (M x K) * B (K x N)
+// =========================================================
+int runTest(int m, int k, int n) {
     double start_time, end_time;
-    // Declare loop variables at the top of main for simplicity
-    int i, j, k;
 
-    printf("--- Final Matrix Multiplication Test (N=%d) ---\n", N);
-    
+    printf("--- Final Matrix Multiplication Test (M=%d, K=%d, N=%d) ---\n", m, k, n);
+    printf("Micro-kernels: %s (selected at startup via CPUID)\n", active_kernels->name);
+
     // =========================================================
     // 1. INITIALIZATION
     // =========================================================
-    printf("Initializing matrices A and B...\n");
-    for (i = 0; i < N; i++) {
-        for (j = 0; j < N; j++) {
-            A[i][j] = i + 1;
-            B[i][j] = j + 1;
-            C_seq[i][j] = 0;
-            C_par[i][j] = 0;
-        }
+    printf("Initializing matrices A and B (parallel first touch, %d threads)...\n", omp_get_max_threads());
+    int *A = allocMatrix(m, k), *B = allocMatrix(k, n);
+    int *C_seq = allocMatrix(m, n), *C_par = allocMatrix(m, n);
+    // Float twins of A/B/C for the float micro-kernels.
+    float *A_f = allocMatrix(m, k), *B_f = allocMatrix(k, n), *C_f = allocMatrix(m, n);
+    if (!A || !B || !C_seq || !C_par || !A_f || !B_f || !C_f) {
+        perror("Failed to allocate matrices");
+        return 1;
     }
 
+    placeThreads();
+    initMatrices(m, n, k, A, B, C_par);
+    #pragma omp parallel for schedule(static)
+    for (long idx = 0; idx < (long)m * k; idx++) A_f[idx] = (float)A[idx];
+    #pragma omp parallel for schedule(static)
+    for (long idx = 0; idx < (long)k * n; idx++) B_f[idx] = (float)B[idx];
+    reportPlacement(m, k, A);
+
     // =========================================================
     // 2. SEQUENTIAL EXECUTION
     // =========================================================
     printf("\nSequential Multiplication (Baseline)...\n");
     start_time = omp_get_wtime();
-    
-    for (i = 0; i < N; i++) {
-        for (j = 0; j < N; j++) {
-            int sum = 0;
-            for (k = 0; k < N; k++) {
-                sum += A[i][k] * B[k][j];
-            }
-            C_seq[i][j] = sum;
-        }
-    }
-
+    gemmNaive(m, n, k, A, B, C_seq);
     end_time = omp_get_wtime();
-    printf("   Sequential Time: %.6f seconds\n", end_time - start_time);
-
+    double seq_time = end_time - start_time;
+    printf("   Sequential Time: %.6f seconds (%.2f GFLOP/s)\n", seq_time, gflops(m, n, k, seq_time));
 
     // =========================================================
-    // 3. PARALLEL EXECUTION (Meets all constraints)
+    // 3. PARALLEL EXECUTION (Cache-blocked, tiled GEMM)
     // =========================================================
-    printf("\nParallel Multiplications (2, 4, 8 Threads)...\n");
-    // Enable nested parallelism, necessary for parallelizing the inner 'k' loop
-    omp_set_nested(1); 
+    printf("\nParallel Blocked Multiplications (2, 4, 8 Threads)...\n");
 
     int thread_counts[] = {2, 4, 8};
     for (int t = 0; t < 3; t++) {
         int threads = thread_counts[t];
         omp_set_num_threads(threads);
+        placeThreads();
 
-        // Reset C_par for the new run
-        for (i = 0; i < N; i++) {
-            for (j = 0; j < N; j++) { C_par[i][j] = 0; }
-        }
+        // Pack B once per multiply; timed separately so the amortization is visible.
+        double pack_time;
+        double total_time = timedGemm(m, n, k, A, B, C_par, &pack_time);
+        int ok = freivalds(m, n, k, A, B, C_par, FREIVALDS_ROUNDS, (unsigned)t) == 0;
+        printf("   Parallel Time (%d Threads): %.6f seconds (Pack: %.6f s, Multiply: %.6f s, Speedup: %.2fx, %.2f GFLOP/s) [%s]\n",
+               threads, total_time, pack_time, total_time - pack_time, seq_time / total_time,
+               gflops(m, n, k, total_time), ok ? "verified" : "FAILED");
+    }
+
+    // =========================================================
+    // 3b. TASK-PARALLEL RECURSIVE MULTIPLY
+    // =========================================================
+    printf("\nRecursive Task-Parallel Multiplication (cutoff=%d, Strassen for dims >= %d)...\n",
+           rec_cutoff, strassen_min);
+    for (int t = 0; t < 3; t++) {
+        int threads = thread_counts[t];
+        omp_set_num_threads(threads);
+        placeThreads();
 
         start_time = omp_get_wtime();
+        gemmRecursive(m, n, k, A, B, C_par);
+        double rec_time = omp_get_wtime() - start_time;
 
-        // Requirement 1: #pragma omp parallel for to divide rows among threads (outer loop 'i')
-        // Loop variable 'i' is automatically private.
-        #pragma omp parallel for 
-        for (i = 0; i < N; i++) {
-            // The 'j' loop is executed sequentially by the thread assigned to row 'i', so 'j' is safe.
-            for (j = 0; j < N; j++) {
-                int sum = 0; // This 'sum' is initialized and used for C_par[i][j]
-                
-                // Requirement 2: Use reduction(+:sum) inside the inner loop ('k')
-                // Loop variable 'k' is automatically private. The 'sum' variable is made private, 
-                // and the final result is safely reduced (combined) at the end of the k-loop.
-                #pragma omp parallel for reduction(+:sum)
-                for (k = 0; k < N; k++) {
-                    sum += A[i][k] * B[k][j];
-                }
-                
-                C_par[i][j] = sum;
-            }
+        int ok = freivalds(m, n, k, A, B, C_par, FREIVALDS_ROUNDS, (unsigned)t) == 0;
+        printf("   Recursive Time (%d Threads): %.6f seconds (Speedup: %.2fx, %.2f GFLOP/s) [%s]\n",
+               threads, rec_time, seq_time / rec_time, gflops(m, n, k, rec_time), ok ? "verified" : "FAILED");
+    }
+
+    // =========================================================
+    // 4. MICRO-KERNEL CHECK (every kernel this CPU supports)
+    // =========================================================
+    printf("\nMicro-kernel Check (int32 and float vs C_seq, bit-exact)...\n");
+    const KernelSet *selected = active_kernels;
+    int *Bp = packB(k, n, B, n);
+    float *Bp_f = packB(k, n, B_f, n);
+    if (!Bp || !Bp_f) {
+        perror("Failed to allocate packed B");
+        return 1;
+    }
+
+    for (int s = 0; s < N_KERNEL_SETS; s++) {
+        if (!kernelSupported(&kernel_sets[s])) {
+            printf("   %-7s: not supported on this CPU\n", kernel_sets[s].name);
+            continue;
         }
+        active_kernels = &kernel_sets[s];
+
+        start_time = omp_get_wtime();
+        gemmPacked(m, n, k, A, k, Bp, C_par, n);
+        double time_i32 = omp_get_wtime() - start_time;
 
-        end_time = omp_get_wtime();
-        printf("   Parallel Time (%d Threads): %.6f seconds\n", threads, end_time - start_time);
+        start_time = omp_get_wtime();
+        gemmPackedF(m, n, k, A_f, k, Bp_f, C_f, n);
+        double time_f32 = omp_get_wtime() - start_time;
+
+        long bad_i32 = 0, bad_f32 = 0;
+        for (long idx = 0; idx < (long)m * n; idx++) {
+            bad_i32 += C_par[idx] != C_seq[idx];
+            bad_f32 += C_f[idx] != (float)C_seq[idx];
+        }
+        printf("   %-7s: int32 %.6f s [%s], float %.6f s [%s]\n", kernel_sets[s].name,
+               time_i32, bad_i32 ? "MISMATCH" : "exact", time_f32, bad_f32 ? "MISMATCH" : "exact");
     }
-    
+    active_kernels = selected;
+    free(Bp); free(Bp_f);
+
     // =========================================================
-    // 4. VERIFICATION
+    // 5. VERIFICATION
     // =========================================================
     printf("\n--- Verification ---\n");
-    if (C_seq[0][0] == C_par[0][0]) {
-        printf("Verification successful! C[0][0] = %d\n", C_seq[0][0]);
+    // Full-matrix randomized check of the engine's result, timed against the multiply itself.
+    // Re-place after resizing: threads added to the team would inherit the master's single-CPU mask.
+    omp_set_num_threads(omp_get_num_procs());
+    placeThreads();
+    double gemm_time = timedGemm(m, n, k, A, B, C_par, NULL);
+    start_time = omp_get_wtime();
+    int failed = freivalds(m, n, k, A, B, C_par, FREIVALDS_ROUNDS, 12345u);
+    double check_time = omp_get_wtime() - start_time;
+    if (failed == 0) {
+        printf("Verification successful! Freivalds, %d rounds over all %ld entries (error bound 2^-%d)\n",
+               FREIVALDS_ROUNDS, (long)m * n, FREIVALDS_ROUNDS);
     } else {
-        printf("Verification FAILED. Sequential C[0][0]=%d, Parallel C_par[0][0]=%d\n", C_seq[0][0], C_par[0][0]);
+        printf("Verification FAILED. Freivalds: %d of %d rounds detected a mismatch\n", failed, FREIVALDS_ROUNDS);
     }
+    printf("   Check Time: %.6f seconds (multiply: %.6f seconds)\n", check_time, gemm_time);
+
+    // Sanity check of the checker: a single corrupted entry in the middle of C must be caught.
+    long victim = (long)(m / 2) * n + n / 2;
+    C_par[victim] += 1;
+    failed = freivalds(m, n, k, A, B, C_par, FREIVALDS_ROUNDS, 12345u);
+    printf("   Corrupted C[%d][%d]: %s (%d of %d rounds)\n", m / 2, n / 2,
+           failed ? "detected" : "NOT detected", failed, FREIVALDS_ROUNDS);
+    C_par[victim] -= 1;
 
     printf("\n--- Test Complete ---\n");
 
+    free(A); free(B); free(C_seq); free(C_par);
+    free(A_f); free(B_f); free(C_f);
+    return 0;
+}
+
+// =========================================================
+// Size sweep: square N x N x N from min to max in ~1.5x steps
+// =========================================================
+// Times the naive baseline (up to SWEEP_NAIVE_MAX), the blocked engine on one thread and on
+// the full team, so the size where parallelism starts to pay off can be read off one run.
+int runSweep(int min_n, int max_n) {
+    int max_threads = omp_get_max_threads();
+
+    printf("--- Matrix Multiplication Size Sweep (N=%d..%d, %d threads, %s kernels, %s) ---\n",
+           min_n, max_n, max_threads, active_kernels->name, interleave_pages ? "interleaved" : "first touch");
+    placeThreads();
+    printf("%6s | %10s %8s | %10s %8s | %10s %8s | %7s | %10s %8s\n", "N",
+           "naive s", "GFLOP/s", "1T s", "GFLOP/s", "par s", "GFLOP/s", "par/1T", "rec s", "GFLOP/s");
+
+    for (int n = min_n; n <= max_n; n = n % 3 == 0 ? n / 3 * 4 : n / 2 * 3) {
+        int *A = allocMatrix(n, n), *B = allocMatrix(n, n);
+        // C_ref only receives the naive result for timing; every engine result is checked with Freivalds.
+        int *C_ref = allocMatrix(n, n), *C = allocMatrix(n, n);
+        if (!A || !B || !C_ref || !C) {
+            perror("Failed to allocate matrices");
+            return 1;
+        }
+        omp_set_num_threads(max_threads);
+        placeThreads();
+        initMatrices(n, n, n, A, B, C);
+
+        char naive_s[16] = "-", naive_gf[16] = "-";
+        if (n <= SWEEP_NAIVE_MAX) {
+            double start_time = omp_get_wtime();
+            gemmNaive(n, n, n, A, B, C_ref);
+            double t = omp_get_wtime() - start_time;
+            snprintf(naive_s, sizeof(naive_s), "%.6f", t);
+            snprintf(naive_gf, sizeof(naive_gf), "%.2f", gflops(n, n, n, t));
+        }
+
+        omp_set_num_threads(1);
+        placeThreads();
+        double t1 = timedGemm(n, n, n, A, B, C, NULL);
+        omp_set_num_threads(max_threads);
+        placeThreads();
+        double tp = timedGemm(n, n, n, A, B, C, NULL);
+        int bad = freivalds(n, n, n, A, B, C, FREIVALDS_ROUNDS, (unsigned)n) != 0;
+
+        double start_time = omp_get_wtime();
+        gemmRecursive(n, n, n, A, B, C);
+        double tr = omp_get_wtime() - start_time;
+        bad |= freivalds(n, n, n, A, B, C, FREIVALDS_ROUNDS, (unsigned)n + 1) != 0;
+
+        printf("%6d | %10s %8s | %10.6f %8.2f | %10.6f %8.2f | %6.2fx | %10.6f %8.2f", n, naive_s, naive_gf,
+               t1, gflops(n, n, n, t1), tp, gflops(n, n, n, tp), t1 / tp, tr, gflops(n, n, n, tr));
+        if (bad) {
+            printf("  MISMATCH");
+        }
+        printf("\n");
+
+        free(A); free(B); free(C_ref); free(C);
+    }
     return 0;
 }
+
+// =========================================================
+// Incremental product: C = A * B kept up to date under small edits
+// =========================================================
+// The product object owns A, B (plus its packed panels) and C. Writes go through
+// matProductSetA / matProductSetB, which mark the touched row of A or column of B dirty.
+// matProductUpdate repacks only the B panels that hold dirty columns, then recomputes only the
+// affected rows (A edits) and columns (B edits) of C with the blocked engine, falling back to a
+// full multiply when more than INCR_FULL_FRACTION of C would have to be redone anyway.
+#define INCR_FULL_FRACTION 0.5
+
+typedef struct {
+    int m, k, n;
+    int *A, *B, *C;
+    int *Bp;                   // B in packB layout, kept in sync panel by panel
+    unsigned char *dirty_row;  // m flags: row i of A changed since the last update
+    unsigned char *dirty_col;  // n flags: column j of B changed since the last update
+    int valid;                 // C has been computed at least once
+    double flops_done, flops_skipped; // totals over all updates (multiply-adds * 2)
+} MatProduct;
+
+void matProductFree(MatProduct *P) {
+    if (!P) return;
+    free(P->A); free(P->B); free(P->C); free(P->Bp);
+    free(P->dirty_row); free(P->dirty_col);
+    free(P);
+}
+
+// Returns NULL on allocation failure, with everything allocated so far released.
+MatProduct *matProductCreate(int m, int k, int n) {
+    MatProduct *P = calloc(1, sizeof(MatProduct));
+    if (!P) return NULL;
+    P->m = m; P->k = k; P->n = n;
+    P->A = P->B = P->C = P->Bp = NULL; // so matProductFree is safe after a partial failure
+    P->dirty_row = P->dirty_col = NULL;
+    P->A = allocMatrix(m, k);
+    P->B = allocMatrix(k, n);
+    P->C = allocMatrix(m, n);
+    P->Bp = aligned_alloc(64, (size_t)((n + NR - 1) / NR) * k * NR * sizeof(int));
+    P->dirty_row = calloc(m, 1);
+    P->dirty_col = calloc(n, 1);
+    if (!P->A || !P->B || !P->C || !P->Bp || !P->dirty_row || !P->dirty_col) {
+        matProductFree(P);
+        return NULL;
+    }
+    return P;
+}
+
+void matProductSetA(MatProduct *P, int i, int p, int value) {
+    if (P->A[(long)i * P->k + p] != value) {
+        P->A[(long)i * P->k + p] = value;
+        P->dirty_row[i] = 1;
+    }
+}
+
+void matProductSetB(MatProduct *P, int p, int j, int value) {
+    if (P->B[(long)p * P->n + j] != value) {
+        P->B[(long)p * P->n + j] = value;
+        P->dirty_col[j] = 1;
+    }
+}
+
+// Bring C up to date. Returns the fraction of the full multiply that was actually performed.
+double matProductUpdate(MatProduct *P) {
+    int m = P->m, k = P->k, n = P->n;
+    double full = 2.0 * m * n * k;
+
+    int *rows = malloc((m ? m : 1) * sizeof(int)), *cols = malloc((n ? n : 1) * sizeof(int));
+    if (!rows || !cols) {
+        perror("Failed to allocate dirty lists");
+        exit(1);
+    }
+    int r = 0, c = 0;
+    for (int i = 0; i < m; i++) if (P->dirty_row[i]) rows[r++] = i;
+    for (int j = 0; j < n; j++) if (P->dirty_col[j]) cols[c++] = j;
+
+    // Keep the packed copy of B current: only panels that contain a dirty column are redone.
+    int panels = (n + NR - 1) / NR;
+    #pragma omp parallel for schedule(dynamic)
+    for (int p = 0; p < panels; p++) {
+        int stale = !P->valid;
+        for (int j = p * NR; j < p * NR + NR && j < n && !stale; j++) stale = P->dirty_col[j];
+        if (stale) packPanel(k, n, P->B, n, (Word*)P->Bp, p);
+    }
+
+    double work = 2.0 * k * ((double)r * n + (double)m * c);
+    if (!P->valid || work > INCR_FULL_FRACTION * full) {
+        gemmPacked(m, n, k, P->A, k, P->Bp, P->C, n);
+        work = full;
+    } else {
+        if (r > 0) {
+            // Dirty rows: C[rows, :] = A[rows, :] * B, on a compacted copy of those rows.
+            int *A_sub = allocMatrix(r, k), *C_sub = allocMatrix(r, n);
+            if (!A_sub || !C_sub) {
+                perror("Failed to allocate update buffers");
+                exit(1);
+            }
+            #pragma omp parallel for schedule(static)
+            for (int q = 0; q < r; q++) memcpy(A_sub + (long)q * k, P->A + (long)rows[q] * k, k * sizeof(int));
+            gemmPacked(r, n, k, A_sub, k, P->Bp, C_sub, n);
+            #pragma omp parallel for schedule(static)
+            for (int q = 0; q < r; q++) memcpy(P->C + (long)rows[q] * n, C_sub + (long)q * n, n * sizeof(int));
+            free(A_sub); free(C_sub);
+        }
+        if (c > 0) {
+            // Dirty columns: C[:, cols] = A * B[:, cols], on a compacted copy of those columns.
+            int *B_sub = allocMatrix(k, c), *C_sub = allocMatrix(m, c);
+            if (!B_sub || !C_sub) {
+                perror("Failed to allocate update buffers");
+                exit(1);
+            }
+            #pragma omp parallel for schedule(static)
+            for (int p = 0; p < k; p++) {
+                for (int q = 0; q < c; q++) B_sub[(long)p * c + q] = P->B[(long)p * n + cols[q]];
+            }
+            timedGemm(m, c, k, P->A, B_sub, C_sub, NULL);
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < m; i++) {
+                for (int q = 0; q < c; q++) P->C[(long)i * n + cols[q]] = C_sub[(long)i * c + q];
+            }
+            free(B_sub); free(C_sub);
+        }
+    }
+
+    memset(P->dirty_row, 0, m);
+    memset(P->dirty_col, 0, n);
+    P->valid = 1;
+    P->flops_done += work;
+    P->flops_skipped += full - work;
+    free(rows); free(cols);
+    return work / full;
+}
+
+// --- Incremental demo: a few rows of A (then a few columns of B) change between multiplies ---
+int runIncremental(int m, int k, int n, int changes) {
+    printf("--- Incremental Matrix Product (M=%d, K=%d, N=%d, %d rows/cols change per step) ---\n",
+           m, k, n, changes);
+
+    MatProduct *P = matProductCreate(m, k, n);
+    if (!P) {
+        perror("Failed to allocate product");
+        return 1;
+    }
+    initMatrices(m, n, k, P->A, P->B, P->C);
+
+    double start_time = omp_get_wtime();
+    matProductUpdate(P);
+    double full_time = omp_get_wtime() - start_time;
+    printf("   Initial full multiply: %.6f seconds\n", full_time);
+
+    unsigned seed = 1;
+    int failed = 0;
+    for (int step = 1; step <= 6; step++) {
+        int edit_b = step > 4; // steps 1-4 edit rows of A, steps 5-6 edit columns of B
+        for (int e = 0; e < changes; e++) {
+            seed = seed * 1103515245u + 12345u;
+            if (edit_b) {
+                int j = (int)(seed >> 8) % n;
+                for (int p = 0; p < k; p++) matProductSetB(P, p, j, (int)((seed + p) % 16) + 1);
+            } else {
+                int i = (int)(seed >> 8) % m;
+                for (int p = 0; p < k; p++) matProductSetA(P, i, p, (int)((seed + p) % 16) + 1);
+            }
+        }
+
+        start_time = omp_get_wtime();
+        double fraction = matProductUpdate(P);
+        double step_time = omp_get_wtime() - start_time;
+        int bad = freivalds(m, n, k, P->A, P->B, P->C, FREIVALDS_ROUNDS, (unsigned)step) != 0;
+        failed |= bad;
+        printf("   Step %d (%s edits): %.6f seconds, %.2f%% of the work, %.1fx faster than full [%s]\n",
+               step, edit_b ? "B column" : "A row", step_time, 100.0 * fraction,
+               full_time / step_time, bad ? "FAILED" : "verified");
+    }
+
+    printf("   Work skipped overall: %.2f of %.2f GFLOP (%.2f%%)\n", P->flops_skipped * 1e-9,
+           (P->flops_done + P->flops_skipped) * 1e-9,
+           100.0 * P->flops_skipped / (P->flops_done + P->flops_skipped));
+    matProductFree(P);
+    return failed;
+}
+
+#ifdef HAVE_MMAP
+// =========================================================
+// Out-of-core multiply over memory-mapped matrix files
+// =========================================================
+// File format: a MATRIX_FILE_HEADER-byte header followed by the row-major int32 payload.
+// The header is fixed at 64 KiB, the largest page size Linux supports on common hardware and a
+// multiple of the smaller ones (4 and 16 KiB), so the payload starts on a page boundary whatever
+// pageBytes() is at run time. The on-disk layout therefore does not depend on the machine.
+#define MATRIX_FILE_MAGIC "OSMATRX2"
+#define MATRIX_FILE_HEADER 65536
+// Default working-set budget for the streaming multiply (--ooc ... [budget_mb]).
+#define OOC_BUDGET_MB 256
+
+typedef struct {
+    char magic[8];
+    uint32_t elem_size; // bytes per element (4)
+    uint32_t reserved;
+    uint64_t rows, cols;
+} MatrixFileHeader;
+
+typedef struct {
+    int fd;
+    char *map;        // whole file, header included
+    size_t map_bytes;
+    int rows, cols;
+    int *data;        // payload, row-major
+} MappedMatrix;
+
+// Create (or truncate) a rows x cols matrix file and map it read-write.
+int matrixFileCreate(const char *path, int rows, int cols, MappedMatrix *mm) {
+    mm->map_bytes = MATRIX_FILE_HEADER + (size_t)rows * cols * sizeof(int);
+    mm->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (mm->fd < 0) return -1;
+    if (ftruncate(mm->fd, (off_t)mm->map_bytes) != 0) {
+        close(mm->fd);
+        return -1;
+    }
+    mm->map = mmap(NULL, mm->map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, mm->fd, 0);
+    if (mm->map == MAP_FAILED) {
+        close(mm->fd);
+        return -1;
+    }
+
+    MatrixFileHeader hdr = {0};
+    memcpy(hdr.magic, MATRIX_FILE_MAGIC, sizeof(hdr.magic));
+    hdr.elem_size = sizeof(int);
+    hdr.rows = (uint64_t)rows;
+    hdr.cols = (uint64_t)cols;
+    memcpy(mm->map, &hdr, sizeof(hdr));
+
+    mm->rows = rows;
+    mm->cols = cols;
+    mm->data = (int*)(mm->map + MATRIX_FILE_HEADER);
+    return 0;
+}
+
+// Map an existing matrix file; the header is validated against the file size. The dimensions
+// come from the file, so they are range-checked (each and their product at most INT_MAX, which
+// also keeps the size arithmetic below from wrapping) before they are trusted.
+int matrixFileOpen(const char *path, int writable, MappedMatrix *mm) {
+    struct stat st;
+    MatrixFileHeader hdr;
+
+    mm->fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (mm->fd < 0) return -1;
+    if (fstat(mm->fd, &st) != 0 || (size_t)st.st_size < MATRIX_FILE_HEADER ||
+        pread(mm->fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) ||
+        memcmp(hdr.magic, MATRIX_FILE_MAGIC, sizeof(hdr.magic)) != 0 || hdr.elem_size != sizeof(int) ||
+        hdr.rows > INT_MAX || hdr.cols > INT_MAX || hdr.rows * hdr.cols > INT_MAX ||
+        (uint64_t)st.st_size - MATRIX_FILE_HEADER != hdr.rows * hdr.cols * sizeof(int)) {
+        fprintf(stderr, "%s: not a valid matrix file\n", path);
+        close(mm->fd);
+        return -1;
+    }
+
+    mm->map_bytes = (size_t)st.st_size;
+    mm->map = mmap(NULL, mm->map_bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, mm->fd, 0);
+    if (mm->map == MAP_FAILED) {
+        close(mm->fd);
+        return -1;
+    }
+    mm->rows = (int)hdr.rows;
+    mm->cols = (int)hdr.cols;
+    mm->data = (int*)(mm->map + MATRIX_FILE_HEADER);
+    return 0;
+}
+
+void matrixFileClose(MappedMatrix *mm) {
+    msync(mm->map, mm->map_bytes, MS_SYNC);
+    munmap(mm->map, mm->map_bytes);
+    close(mm->fd);
+}
+
+// madvise the payload rows [row0, row1), widened to whole pages.
+void adviseRows(const MappedMatrix *mm, long row0, long row1, int advice) {
+    if (row1 > mm->rows) row1 = mm->rows;
+    if (row0 >= row1) return;
+    size_t begin = MATRIX_FILE_HEADER + (size_t)row0 * mm->cols * sizeof(int);
+    size_t end = MATRIX_FILE_HEADER + (size_t)row1 * mm->cols * sizeof(int);
+    begin = begin / pageBytes() * pageBytes();
+    madvise(mm->map + begin, end - begin, advice);
+}
+
+// --- Streaming tiled GEMM: C = A * B with all three matrices in mapped files ---
+// C is produced one band of mb rows at a time. For each band, B streams through in blocks of
+// kb rows: each block is packed (which pages it in) and multiplied into the band with the
+// in-memory engine. While a block is being multiplied, MADV_WILLNEED asks the kernel to read
+// the next one ahead; finished bands of C are written back asynchronously and released.
+// The band and block sizes are chosen so A band + C band + B block + packed block fit in budget.
+int gemmOutOfCore(const MappedMatrix *A, const MappedMatrix *B, MappedMatrix *C, size_t budget,
+                  double *pack_time) {
+    int m = A->rows, k = A->cols, n = B->cols;
+    if (B->rows != k || C->rows != m || C->cols != n) return -1;
+
+    size_t half = budget / 2;
+    long mb = (long)(half / ((size_t)(k + n) * sizeof(int)));
+    long kb = (long)(half / (2 * (size_t)n * sizeof(int)));
+    if (mb < MR) mb = MR;
+    if (kb < 1) kb = 1;
+    if (mb > m) mb = m;
+    if (kb > k) kb = k;
+    *pack_time = 0;
+
+    madvise(A->map, A->map_bytes, MADV_SEQUENTIAL);
+    madvise(C->map, C->map_bytes, MADV_SEQUENTIAL);
+    adviseRows(A, 0, mb, MADV_WILLNEED);
+    adviseRows(B, 0, kb, MADV_WILLNEED);
+
+    for (long i0 = 0; i0 < m; i0 += mb) {
+        int rows = (int)(i0 + mb < m ? mb : m - i0);
+        const int *a_band = A->data + i0 * k;
+        int *c_band = C->data + i0 * n;
+
+        for (long p0 = 0; p0 < k; p0 += kb) {
+            int depth = (int)(p0 + kb < k ? kb : k - p0);
+
+            // Read ahead: the next B block, or the next A band and the first B block again.
+            if (p0 + kb < k) {
+                adviseRows(B, p0 + kb, p0 + 2 * kb, MADV_WILLNEED);
+            } else if (i0 + mb < m) {
+                adviseRows(A, i0 + mb, i0 + 2 * mb, MADV_WILLNEED);
+                adviseRows(B, 0, kb, MADV_WILLNEED);
+            }
+
+            double start = omp_get_wtime();
+            int *Bp = packB(depth, n, B->data + p0 * n, n);
+            *pack_time += omp_get_wtime() - start;
+            if (!Bp) return -1;
+
+            gemmTiles(rows, n, depth, (const Word*)(a_band + p0), k, (const Word*)Bp, (Word*)c_band, n,
+                      active_kernels->i32, p0 > 0);
+            free(Bp);
+        }
+
+        // The band is final: start writeback and drop the pages we no longer need, C's as well as
+        // A's. On a shared file mapping MADV_DONTNEED only unmaps: dirty pages stay in the page
+        // cache until written back, so nothing is lost, but they no longer count against the
+        // budget in this process.
+        size_t c_begin = MATRIX_FILE_HEADER + (size_t)i0 * n * sizeof(int);
+        size_t c_end = c_begin + (size_t)rows * n * sizeof(int);
+        c_begin = c_begin / pageBytes() * pageBytes();
+        msync(C->map + c_begin, c_end - c_begin, MS_ASYNC);
+        adviseRows(C, i0, i0 + rows, MADV_DONTNEED);
+        adviseRows(A, i0, i0 + rows, MADV_DONTNEED);
+    }
+    return 0;
+}
+
+// --- Out-of-core demo: write A and B files in DIR, multiply into DIR/C.mat, verify ---
+int runOutOfCore(const char *dir, int m, int k, int n, size_t budget) {
+    char path_a[1024], path_b[1024], path_c[1024];
+    snprintf(path_a, sizeof(path_a), "%s/A.mat", dir);
+    snprintf(path_b, sizeof(path_b), "%s/B.mat", dir);
+    snprintf(path_c, sizeof(path_c), "%s/C.mat", dir);
+
+    printf("--- Out-of-Core Matrix Multiplication (M=%d, K=%d, N=%d, budget %zu MB) ---\n",
+           m, k, n, budget >> 20);
+
+    MappedMatrix A, B, C;
+    double start_time = omp_get_wtime();
+    if (matrixFileCreate(path_a, m, k, &A) != 0 || matrixFileCreate(path_b, k, n, &B) != 0) {
+        perror("Failed to create matrix files");
+        return 1;
+    }
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < m; i++) {
+        for (long p = 0; p < k; p++) A.data[i * k + p] = (int)(i % 16 + 1);
+    }
+    #pragma omp parallel for schedule(static)
+    for (long p = 0; p < k; p++) {
+        for (long j = 0; j < n; j++) B.data[p * n + j] = (int)(j % 16 + 1);
+    }
+    matrixFileClose(&A);
+    matrixFileClose(&B);
+    double write_time = omp_get_wtime() - start_time;
+    double in_bytes = ((double)m * k + (double)k * n) * sizeof(int);
+    printf("   Wrote %s, %s: %.1f MB in %.3f s (%.1f MB/s)\n", path_a, path_b,
+           in_bytes / 1e6, write_time, in_bytes / 1e6 / write_time);
+
+    if (matrixFileOpen(path_a, 0, &A) != 0 || matrixFileOpen(path_b, 0, &B) != 0 ||
+        matrixFileCreate(path_c, m, n, &C) != 0) {
+        perror("Failed to map matrix files");
+        return 1;
+    }
+
+    double pack_time;
+    start_time = omp_get_wtime();
+    if (gemmOutOfCore(&A, &B, &C, budget, &pack_time) != 0) {
+        fprintf(stderr, "Out-of-core multiply failed\n");
+        return 1;
+    }
+    msync(C.map, C.map_bytes, MS_SYNC);
+    double ooc_time = omp_get_wtime() - start_time;
+    printf("   Out-of-core Time: %.6f seconds (%.2f GFLOP/s, pack/page-in %.6f s)\n",
+           ooc_time, gflops(m, n, k, ooc_time), pack_time);
+
+    // Whole-matrix check; each round streams A, B and C once more, so only a few rounds.
+    int failed = freivalds(m, n, k, A.data, B.data, C.data, 3, 777u);
+    printf("   Freivalds (3 rounds): %s\n", failed ? "FAILED" : "verified");
+
+    // In-memory reference on the same data when it comfortably fits in RAM.
+    double total_bytes = in_bytes + (double)m * n * sizeof(int);
+    double ram_bytes = (double)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    if (total_bytes * 2 < ram_bytes) {
+        int *C_mem = allocMatrix(m, n);
+        if (C_mem) {
+            double mem_time = timedGemm(m, n, k, A.data, B.data, C_mem, NULL);
+            printf("   In-memory Time:   %.6f seconds (%.2f GFLOP/s, files in page cache)\n",
+                   mem_time, gflops(m, n, k, mem_time));
+            free(C_mem);
+        }
+    }
+
+    matrixFileClose(&A);
+    matrixFileClose(&B);
+    matrixFileClose(&C);
+    printf("   Result written to %s\n", path_c);
+    return failed != 0;
+}
+#endif
+
+// Usage:
+//   matrix_mul [options]                    M = K = N = 500
+//   matrix_mul [options] N                  square N x N x N
+//   matrix_mul [options] M K N              A is M x K, B is K x N
+//   matrix_mul [options] --sweep [min max]  square sizes min..max (default 64..4096)
+//   matrix_mul --ooc DIR M K N [budget_mb]  out-of-core multiply of files in DIR
+//   matrix_mul --incremental [N [changes]]  incremental updates of an N x N x N product
+// Options:
+//   --cutoff C     recursive multiply switches to the serial kernel at dims <= C
+//   --strassen S   take a Strassen step for dims >= S (0 disables)
+//   --interleave   spread matrix pages over all NUMA nodes instead of parallel first touch
+int main(int argc, char **argv) {
+    selectKernels();
+
+    while (argc > 1) {
+        if (argc > 2 && strcmp(argv[1], "--cutoff") == 0) {
+            rec_cutoff = atoi(argv[2]);
+        } else if (argc > 2 && strcmp(argv[1], "--strassen") == 0) {
+            strassen_min = atoi(argv[2]);
+        } else if (strcmp(argv[1], "--interleave") == 0) {
+            interleave_pages = 1;
+            argc -= 1;
+            argv += 1;
+            continue;
+        } else {
+            break;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (rec_cutoff < 16) {
+        fprintf(stderr, "Cutoff must be at least 16\n");
+        return 1;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--ooc") == 0) {
+#ifdef HAVE_MMAP
+        if (argc < 6) {
+            fprintf(stderr, "Usage: %s --ooc DIR M K N [budget_mb]\n", argv[0]);
+            return 1;
+        }
+        int m = atoi(argv[3]), k = atoi(argv[4]), n = atoi(argv[5]);
+        long budget_mb = argc > 6 ? atol(argv[6]) : OOC_BUDGET_MB;
+        if (m <= 0 || k <= 0 || n <= 0 || budget_mb <= 0) {
+            fprintf(stderr, "Matrix dimensions and budget must be positive\n");
+            return 1;
+        }
+        return runOutOfCore(argv[2], m, k, n, (size_t)budget_mb << 20);
+#else
+        fprintf(stderr, "Out-of-core mode needs mmap\n");
+        return 1;
+#endif
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--incremental") == 0) {
+        int size = argc > 2 ? atoi(argv[2]) : 2000;
+        int changes = argc > 3 ? atoi(argv[3]) : 4;
+        if (size <= 0 || changes <= 0 || changes > size) {
+            fprintf(stderr, "Invalid size or change count\n");
+            return 1;
+        }
+        return runIncremental(size, size, size, changes);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) {
+        int min_n = argc > 2 ? atoi(argv[2]) : SWEEP_MIN;
+        int max_n = argc > 3 ? atoi(argv[3]) : SWEEP_MAX;
+        if (min_n < 2 || max_n < min_n) {
+            fprintf(stderr, "Invalid sweep range %d..%d\n", min_n, max_n);
+            return 1;
+        }
+        return runSweep(min_n, max_n);
+    }
+
+    int m = N_DEFAULT, k = N_DEFAULT, n = N_DEFAULT;
+    if (argc == 2) {
+        m = k = n = atoi(argv[1]);
+    } else if (argc == 4) {
+        m = atoi(argv[1]);
+        k = atoi(argv[2]);
+        n = atoi(argv[3]);
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage: %s [--cutoff C] [--strassen S] [--interleave] [N | M K N | --sweep [min max] | --ooc DIR M K N [budget_mb] | --incremental [N [changes]]]\n", argv[0]);
+        return 1;
+    }
+    if (m <= 0 || k <= 0 || n <= 0) {
+        fprintf(stderr, "Matrix dimensions must be positive\n");
+        return 1;
+    }
+    return runTest(m, k, n);
+}
@@ -1,9 +1,115 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <omp.h>
 #include <time.h> // For timing
+#include "csr.h"
 
 #define N_MAT 4 // Size 4x4
 
+// Batched small-matrix multiply: total bytes per operand array (A, B and C each).
+#define BATCH_BYTES (32L << 20)
+
+// --- Fixed-size kernels: C = A * B for one S x S matrix ---
+// S is a compile-time constant, so every loop bound is known and the unroll pragmas let the
+// compiler flatten the whole multiply into straight-line (vectorized) code. The macro stamps
+// out one kernel per size, which is the C equivalent of a template specialization.
+#define DEFINE_SMALL_MATMUL(S)                                                              \
+static inline void matMul##S(const int *restrict a, const int *restrict b, int *restrict c) { \
+    _Pragma("GCC unroll 8")                                                                 \
+    for (int i = 0; i < S; i++) {                                                           \
+        int row[S] = {0};                                                                   \
+        _Pragma("GCC unroll 8")                                                             \
+        for (int k = 0; k < S; k++) {                                                       \
+            _Pragma("GCC unroll 8")                                                         \
+            for (int j = 0; j < S; j++) {                                                   \
+                row[j] += a[i * S + k] * b[k * S + j];                                      \
+            }                                                                               \
+        }                                                                                   \
+        for (int j = 0; j < S; j++) c[i * S + j] = row[j];                                  \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+/* Batched: C[b] = A[b] * B[b] for b < count; the team splits the batch, not the matrix. */ \
+void batchMatMul##S(long count, const int *A, const int *B, int *C) {                      \
+    _Pragma("omp parallel for schedule(static)")                                            \
+    for (long b = 0; b < count; b++) {                                                      \
+        matMul##S(A + b * S * S, B + b * S * S, C + b * S * S);                             \
+    }                                                                                       \
+}
+
+DEFINE_SMALL_MATMUL(4)
+DEFINE_SMALL_MATMUL(8)
+
+// --- Batched entry point: picks the specialized kernel for the given size ---
+// Returns 0 on success, -1 if no kernel was generated for this size.
+int batchMatMul(int size, long count, const int *A, const int *B, int *C) {
+    switch (size) {
+        case 4: batchMatMul4(count, A, B, C); return 0;
+        case 8: batchMatMul8(count, A, B, C); return 0;
+        default: return -1;
+    }
+}
+
+// --- Batch benchmark: per-matrix parallel team (old way) vs batched specialized kernels ---
+void runBatch(int size) {
+    long elems = (long)size * size;
+    long count = BATCH_BYTES / (elems * (long)sizeof(int));
+    int *A = (int*)malloc(count * elems * sizeof(int));
+    int *B = (int*)malloc(count * elems * sizeof(int));
+    int *C = (int*)malloc(count * elems * sizeof(int));
+    if (!A || !B || !C) {
+        perror("Failed to allocate batch");
+        exit(1);
+    }
+
+    for (long idx = 0; idx < count * elems; idx++) {
+        A[idx] = (int)(idx % 7) - 3;
+        B[idx] = (int)(idx % 5) - 2;
+        C[idx] = 0;
+    }
+
+    // Old way: one OpenMP team per matrix. Only a slice of the batch is timed; it is far too slow.
+    long slice = count < 10000 ? count : 10000;
+    double start_w = omp_get_wtime();
+    for (long b = 0; b < slice; b++) {
+        const int *a = A + b * elems, *bm = B + b * elems;
+        int *c = C + b * elems;
+        #pragma omp parallel for
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                int sum = 0;
+                for (int k = 0; k < size; k++) sum += a[i * size + k] * bm[k * size + j];
+                c[i * size + j] = sum;
+            }
+        }
+    }
+    double time_team = omp_get_wtime() - start_w;
+
+    start_w = omp_get_wtime();
+    batchMatMul(size, count, A, B, C);
+    double time_batch = omp_get_wtime() - start_w;
+
+    // Verify the whole batch against a plain triple loop.
+    long bad = 0;
+    for (long b = 0; b < count; b++) {
+        const int *a = A + b * elems, *bm = B + b * elems, *c = C + b * elems;
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                int sum = 0;
+                for (int k = 0; k < size; k++) sum += a[i * size + k] * bm[k * size + j];
+                bad += sum != c[i * size + j];
+            }
+        }
+    }
+
+    printf("%dx%d, %ld matrices:\n", size, size, count);
+    printf("   Team per matrix: %.3e matrices/s (timed on %ld)\n", slice / time_team, slice);
+    printf("   Batched kernel : %.3e matrices/s (%f s) [%s]\n", count / time_batch, time_batch,
+           bad ? "MISMATCH" : "verified");
+
+    free(A); free(B); free(C);
+}
+
 int main() {
     printf("--- TASK 2: Matrix Multiplication with and without ordered ---\n");
 
@@ -81,5 +187,24 @@ int main() {
     printf("Run 1 (Without ordered) shows results in random thread completion order.\n");
     printf("Run 2 (With ordered) prints elements strictly in row-major order (0,0 -> 0,1 ... -> 3,3).\n");
 
+    // --- Run 3: Batched small matrices ---
+    // Real workloads multiply millions of tiny matrices; parallelizing inside each one pays a
+    // team startup per 64 multiply-adds, so the batch is split across threads instead.
+    printf("\n--- RUN 3: Batched Small-Matrix Multiply (%d threads) ---\n", omp_get_max_threads());
+    runBatch(4);
+    runBatch(8);
+
+    // --- Run 4: Density-routed multiply ---
+    // B above is the identity: the dense loops did all N^3 multiplies anyway. matMulAuto checks
+    // operand density first and sends sparse operands through the CSR engine.
+    printf("\n--- RUN 4: Density-Routed Multiply (sparse operands use CSR) ---\n");
+    const char *path = matMulAuto(&A[0][0], &B[0][0], &C[0][0], N_MAT, N_MAT, N_MAT);
+    printf("Path: %s\n", path);
+    for (int i = 0; i < N_MAT; i++) {
+        for (int j = 0; j < N_MAT; j++) printf("%d ", C[i][j]);
+        printf("\n");
+    }
+    runSparse();
+
     return 0;
 }
\ No newline at end of file
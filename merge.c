@@ -2,72 +2,926 @@
 #include <omp.h>
 #include <stdlib.h>
 #include <time.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include "sort_engines.h" // radixSort, loser-tree k-way merge, multiCoRank
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 #define ARRAY_SIZE 16
 #define SEGMENT_SIZE (ARRAY_SIZE / 4)
 #define N_THREADS 4
 
-// --- Helper function for Merge Sort: Merges two sorted sub-arrays ---
-void merge(int arr[], int left, int mid, int right) {
-    int i, j, k;
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
-
-    // Create temporary arrays
-    int L[n1], R[n2];
-
-    // Copy data to temp arrays L[] and R[]
-    for (i = 0; i < n1; i++)
-        L[i] = arr[left + i];
-    for (j = 0; j < n2; j++)
-        R[j] = arr[mid + 1 + j];
-
-    // Merge the temp arrays back into arr[left..right]
-    i = 0; // Initial index of first sub-array
-    j = 0; // Initial index of second sub-array
-    k = left; // Initial index of merged sub-array
-    while (i < n1 && j < n2) {
-        if (L[i] <= R[j]) {
-            arr[k] = L[i];
+// Full parallel sort: default element count (override with the first argument), and the
+// subarray size below which recursion runs serially instead of spawning more tasks.
+#define LARGE_SIZE 20000000L
+#define TASK_CUTOFF 10000
+// Merges at least this long are split by merge path into one sub-merge per thread.
+#define PAR_MERGE_MIN 65536
+// Ranges of at most NETWORK_MAX keys are sorted by the base case instead of recursing further;
+// from NETWORK_MIN keys up that is the AVX2 sorting network (when the CPU has it).
+#define NETWORK_MAX 64
+#define NETWORK_MIN 9
+// Size from which sortInts prefers radixSort (sort_engines.h) over mergeSort.
+#define RADIX_MIN 4096
+// Adaptive natural merge sort: minimum run length (shorter runs are extended by insertion sort),
+// wins in a row before a merge starts galloping, and the most natural runs per key for which
+// sortInts treats the input as presorted.
+#define MIN_RUN 32
+#define MIN_GALLOP 7
+#define ADAPTIVE_MAX_RUNS 0.02
+// Segment sort (k-way merge engine): independently sorted segments per thread.
+#define SEGMENTS_PER_THREAD 4
+// External sort (--external): default memory budget for buffers, in MB.
+#define EXT_MEM_MB 64
+// Top-k selection demo (RUN 4): how many smallest / largest keys to extract.
+#define TOP_K 100
+
+// --- Helper function for Merge Sort: Merges sorted a[0..na) and b[0..nb) into out ---
+// Stable: on equal keys the element of a comes first.
+void mergeRuns(const int a[], long na, const int b[], long nb, int out[]) {
+    long i = 0, j = 0, k = 0;
+
+    while (i < na && j < nb) {
+        if (a[i] <= b[j]) {
+            out[k] = a[i];
             i++;
         } else {
-            arr[k] = R[j];
+            out[k] = b[j];
             j++;
         }
         k++;
     }
 
-    // Copy the remaining elements of L[], if any
-    while (i < n1) {
-        arr[k] = L[i];
+    // Copy the remaining elements of a, if any
+    while (i < na) {
+        out[k] = a[i];
         i++;
         k++;
     }
 
-    // Copy the remaining elements of R[], if any
-    while (j < n2) {
-        arr[k] = R[j];
+    // Copy the remaining elements of b, if any
+    while (j < nb) {
+        out[k] = b[j];
         j++;
         k++;
     }
 }
 
-// --- Helper function for Merge Sort: Recursive divide-and-conquer ---
-void mergeSort(int arr[], int left, int right) {
-    if (left < right) {
-        int mid = left + (right - left) / 2;
+// --- Merge path (co-ranking): how many of the first k merged outputs come from a ---
+// Binary search on the diagonal i + j = k for the first i where a[i] no longer precedes b[k-i-1].
+long coRank(long k, const int a[], long na, const int b[], long nb) {
+    long lo = k > nb ? k - nb : 0;
+    long hi = k < na ? k : na;
+    while (lo < hi) {
+        long i = lo + (hi - lo) / 2;
+        if (a[i] <= b[k - i - 1]) lo = i + 1; // a[i] is among the first k: take more of a
+        else hi = i;
+    }
+    return lo;
+}
+
+// --- Parallel merge: split the output into equal slices, each an independent sequential merge ---
+// Each slice boundary is co-ranked into (i, j), so the P sub-merges touch disjoint input and
+// output ranges and need no synchronisation. Inside a parallel region the slices become tasks of
+// the current team; called from serial code it opens its own region.
+void parallelMerge(const int a[], long na, const int b[], long nb, int out[]) {
+    long n = na + nb;
+    int parts = omp_in_parallel() ? omp_get_num_threads() : omp_get_max_threads();
+    if (n < PAR_MERGE_MIN || parts < 2) {
+        mergeRuns(a, na, b, nb, out);
+        return;
+    }
+
+    if (!omp_in_parallel()) {
+        #pragma omp parallel
+        #pragma omp single
+        parallelMerge(a, na, b, nb, out);
+        return;
+    }
+
+    for (int p = 0; p < parts; p++) {
+        #pragma omp task firstprivate(p)
+        {
+            long k0 = n * p / parts, k1 = n * (p + 1) / parts;
+            long i0 = coRank(k0, a, na, b, nb), i1 = coRank(k1, a, na, b, nb);
+            mergeRuns(a + i0, i1 - i0, b + (k0 - i0), (k1 - i1) - (k0 - i0), out + k0);
+        }
+    }
+    #pragma omp taskwait
+}
+
+// --- Merge Sort step: src[left..mid] and src[mid+1..right] merged into dst[left..right] ---
+// Nothing is copied out first: the caller alternates which array is src and which is dst
+// (ping-pong), so every recursion level reads one array and writes the other exactly once.
+void merge(const int src[], int dst[], long left, long mid, long right) {
+    mergeRuns(src + left, mid - left + 1, src + mid + 1, right - mid, dst + left);
+}
 
-        // Recursive calls
-        mergeSort(arr, left, mid);
-        mergeSort(arr, mid + 1, right);
+// --- Recursion base case: sorting networks for blocks of up to NETWORK_MAX ints ---
+// Below NETWORK_MIN keys an insertion sort is cheapest. Otherwise, with AVX2, the block is padded
+// to 64 with INT_MAX and loaded into eight 8-lane registers, then:
+//   1. an optimal 19-comparator network sorts the 8 registers lane-wise (every column sorted),
+//   2. an 8x8 transpose turns the columns into eight sorted runs of 8,
+//   3. bitonic merges combine runs 8+8 -> 16, 16+16 -> 32, 32+32 -> 64, all in registers.
+// Every step is a branch-free min/max, unlike the data-dependent branch of merge().
+int use_simd_network = 0; // set by selectBaseCase()
+
+void insertionSort(int a[], long n) {
+    for (long i = 1; i < n; i++) {
+        int key = a[i];
+        long j = i - 1;
+        while (j >= 0 && a[j] > key) {
+            a[j + 1] = a[j];
+            j--;
+        }
+        a[j + 1] = key;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+static inline void cmpSwap(__m256i *a, __m256i *b) {
+    __m256i lo = _mm256_min_epi32(*a, *b);
+    *b = _mm256_max_epi32(*a, *b);
+    *a = lo;
+}
+
+// Reverse the 8 lanes of a register (used to turn two ascending runs into one bitonic sequence).
+__attribute__((target("avx2")))
+static inline __m256i reverseLanes(__m256i v) {
+    return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+// Finish a bitonic merge inside one register: compare-exchange at lane distance 4, 2, then 1.
+__attribute__((target("avx2")))
+static inline __m256i bitonicLanes(__m256i v) {
+    __m256i p = _mm256_permute2x128_si256(v, v, 1);
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+    p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+    p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+    return v;
+}
+
+// Merge two ascending runs of `half` registers each, v[0..half) and v[half..2*half), in place.
+__attribute__((target("avx2")))
+static inline void bitonicMerge(__m256i *v, int half) {
+    // Reverse the second run (register order and lanes) so the whole sequence is bitonic
+    for (int i = 0; i < half / 2; i++) {
+        __m256i t = v[half + i];
+        v[half + i] = v[2 * half - 1 - i];
+        v[2 * half - 1 - i] = t;
+    }
+    for (int i = half; i < 2 * half; i++) v[i] = reverseLanes(v[i]);
+
+    // Register-distance stages, then lane-distance stages inside each register
+    for (int dist = half; dist >= 1; dist /= 2) {
+        for (int i = 0; i < 2 * half; i++) {
+            if ((i & dist) == 0) cmpSwap(&v[i], &v[i + dist]);
+        }
+    }
+    for (int i = 0; i < 2 * half; i++) v[i] = bitonicLanes(v[i]);
+}
+
+__attribute__((target("avx2")))
+static void sortNetwork64(int a[], long n) {
+    int block[64];
+    __m256i v[8];
+    for (long i = 0; i < 64; i++) block[i] = i < n ? a[i] : INT_MAX;
+    for (int r = 0; r < 8; r++) v[r] = _mm256_loadu_si256((const __m256i*)(block + 8 * r));
+
+    // 1. Column sort: optimal 8-input network (19 comparators in 6 layers)
+    static const int net[19][2] = {
+        {0, 2}, {1, 3}, {4, 6}, {5, 7},  {0, 4}, {1, 5}, {2, 6}, {3, 7},
+        {0, 1}, {2, 3}, {4, 5}, {6, 7},  {2, 4}, {3, 5},  {1, 4}, {3, 6},
+        {1, 2}, {3, 4}, {5, 6}
+    };
+    for (int c = 0; c < 19; c++) cmpSwap(&v[net[c][0]], &v[net[c][1]]);
+
+    // 2. Transpose 8x8: register r becomes column r, i.e. a sorted run of 8
+    __m256i t[8], u[8];
+    for (int r = 0; r < 8; r += 2) {
+        t[r] = _mm256_unpacklo_epi32(v[r], v[r + 1]);
+        t[r + 1] = _mm256_unpackhi_epi32(v[r], v[r + 1]);
+    }
+    for (int r = 0; r < 8; r += 4) {
+        u[r] = _mm256_unpacklo_epi64(t[r], t[r + 2]);
+        u[r + 1] = _mm256_unpackhi_epi64(t[r], t[r + 2]);
+        u[r + 2] = _mm256_unpacklo_epi64(t[r + 1], t[r + 3]);
+        u[r + 3] = _mm256_unpackhi_epi64(t[r + 1], t[r + 3]);
+    }
+    for (int r = 0; r < 4; r++) {
+        v[r] = _mm256_permute2x128_si256(u[r], u[r + 4], 0x20);
+        v[r + 4] = _mm256_permute2x128_si256(u[r], u[r + 4], 0x31);
+    }
+
+    // 3. Bitonic merges of the runs: 8 -> 16 -> 32 -> 64
+    for (int half = 1; half < 8; half *= 2) {
+        for (int r = 0; r < 8; r += 2 * half) bitonicMerge(v + r, half);
+    }
+
+    for (int r = 0; r < 8; r++) _mm256_storeu_si256((__m256i*)(block + 8 * r), v[r]);
+    memcpy(a, block, n * sizeof(int));
+}
+#endif
+
+void sortSmall(int a[], long n) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (use_simd_network && n >= NETWORK_MIN) {
+        sortNetwork64(a, n);
+        return;
+    }
+#endif
+    insertionSort(a, n);
+}
+
+// Pick the base case once, before any sort runs (CPUID via the compiler builtin).
+void selectBaseCase(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    use_simd_network = __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+// --- Helper function for Merge Sort: Recursive ping-pong divide-and-conquer ---
+// On entry src and dst hold the same elements in [left..right]; on exit dst[left..right] is sorted.
+// The halves are sorted into src (roles swapped) and then merged back into dst. Small ranges
+// are sorted directly in dst by the base case.
+void mergeSplit(int src[], int dst[], long left, long right) {
+    if (right - left < NETWORK_MAX) {
+        sortSmall(dst + left, right - left + 1);
+    } else {
+        long mid = left + (right - left) / 2;
+
+        // Recursive calls, with source and destination swapped
+        mergeSplit(dst, src, left, mid);
+        mergeSplit(dst, src, mid + 1, right);
 
         // Merge the two halves
-        merge(arr, left, mid, right);
+        merge(src, dst, left, mid, right);
+    }
+}
+
+// --- Sort arr[left..right]: one auxiliary buffer for the whole sort, no per-merge allocation ---
+void mergeSort(int arr[], long left, long right) {
+    long n = right - left + 1;
+    if (n < 2) return;
+
+    int *buf = (int*)malloc(n * sizeof(int));
+    if (!buf) {
+        perror("Failed to allocate merge buffer");
+        exit(1);
     }
+    for (long i = 0; i < n; i++) buf[i] = arr[left + i];
+
+    mergeSplit(buf, arr + left, 0, n - 1);
+    free(buf);
 }
 
+// --- Task-parallel Merge Sort: each half above TASK_CUTOFF becomes an OpenMP task ---
+// Must run inside a parallel region (see parallelMergeSort); idle threads pick up the tasks.
+// Same ping-pong contract as mergeSplit: the sorted result ends up in dst.
+void mergeSortTask(int src[], int dst[], long left, long right) {
+    if (right - left < TASK_CUTOFF) {
+        mergeSplit(src, dst, left, right);
+        return;
+    }
+
+    long mid = left + (right - left) / 2;
+
+    // Left half as a task, right half on this thread, then wait for both before merging
+    #pragma omp task
+    mergeSortTask(dst, src, left, mid);
+    mergeSortTask(dst, src, mid + 1, right);
+    #pragma omp taskwait
+
+    // Near the top there are fewer merges than threads, so split each one by merge path
+    parallelMerge(src + left, mid - left + 1, src + mid + 1, right - mid, dst + left);
+}
+
+// --- Sort arr[0..n) using every thread of the team ---
+void parallelMergeSort(int arr[], long n) {
+    if (n < 2) return;
+
+    int *buf = (int*)malloc(n * sizeof(int));
+    if (!buf) {
+        perror("Failed to allocate merge buffer");
+        exit(1);
+    }
+
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(static)
+        for (long i = 0; i < n; i++) buf[i] = arr[i];
+
+        #pragma omp single
+        mergeSortTask(buf, arr, 0, n - 1);
+    }
+
+    free(buf);
+}
+
+// --- Plain (arr, n) entry point for the sequential sort, used by the benchmarks ---
+void sequentialMergeSort(int arr[], long n) {
+    mergeSort(arr, 0, n - 1);
+}
+
+// --- Segment sort: sort SEGMENTS_PER_THREAD segments per thread independently, then k-way merge ---
+void segmentSort(int arr[], long n) {
+    int k = omp_get_max_threads() * SEGMENTS_PER_THREAD;
+    if (k > n) k = n > 0 ? (int)n : 1;
+
+    long *bounds = (long*)malloc((k + 1) * sizeof(long));
+    int *out = (int*)malloc(n * sizeof(int));
+    if (!bounds || !out) {
+        perror("Failed to allocate segment sort buffers");
+        exit(1);
+    }
+    for (int r = 0; r <= k; r++) bounds[r] = n * r / k;
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int r = 0; r < k; r++) {
+        mergeSort(arr, bounds[r], bounds[r + 1] - 1);
+    }
+
+    parallelKWayMerge(arr, bounds, k, out);
+    memcpy(arr, out, n * sizeof(int));
+    free(bounds);
+    free(out);
+}
+
+// --- Adaptive natural merge sort for presorted input (Timsort-style runs + galloping) ---
+// 1. Run detection, one chunk per thread: maximal non-decreasing runs are kept, strictly
+//    decreasing runs are reversed in place (strict, so stability holds), and runs shorter than
+//    MIN_RUN are extended to MIN_RUN by insertion sort.
+// 2. Adjacent runs are merged pairwise, round by round, between arr and one buffer (ping-pong);
+//    every merge is split by merge path so the last rounds still use every thread.
+// 3. Merges gallop: after MIN_GALLOP wins in a row from one side, an exponential search finds how
+//    far that side keeps winning and the whole block is copied at once.
+// Cost is O(n log r) for r runs, and the passes over long runs are mostly block copies, so a sorted
+// log with a few late arrivals sorts in near-linear time.
+
+// First index in a[lo..hi) with a[i] > v (upper) or a[i] >= v (lower), searching from lo outward.
+static long gallopUpper(const int a[], long lo, long hi, int v) {
+    long start = lo, probe = lo, step = 1;
+    while (probe < hi && a[probe] <= v) {
+        lo = probe + 1;
+        probe = start + step;
+        step *= 2;
+    }
+    return upperBound(a, lo, probe < hi ? probe : hi, v);
+}
+
+static long gallopLower(const int a[], long lo, long hi, int v) {
+    long start = lo, probe = lo, step = 1;
+    while (probe < hi && a[probe] < v) {
+        lo = probe + 1;
+        probe = start + step;
+        step *= 2;
+    }
+    return lowerBound(a, lo, probe < hi ? probe : hi, v);
+}
+
+// Stable merge of a[0..na) and b[0..nb) into out, galloping through long one-sided stretches.
+void mergeGallop(const int a[], long na, const int b[], long nb, int out[]) {
+    long i = 0, j = 0, k = 0;
+    int wins_a = 0, wins_b = 0;
+
+    while (i < na && j < nb) {
+        if (a[i] <= b[j]) {
+            out[k++] = a[i++];
+            wins_b = 0;
+            if (++wins_a >= MIN_GALLOP) {
+                long e = gallopUpper(a, i, na, b[j]); // every a <= b[j] goes first
+                memcpy(out + k, a + i, (e - i) * sizeof(int));
+                k += e - i;
+                i = e;
+                wins_a = 0;
+            }
+        } else {
+            out[k++] = b[j++];
+            wins_a = 0;
+            if (++wins_b >= MIN_GALLOP && j < nb) {
+                long e = gallopLower(b, j, nb, a[i]); // every b < a[i] goes first
+                memcpy(out + k, b + j, (e - j) * sizeof(int));
+                k += e - j;
+                j = e;
+                wins_b = 0;
+            }
+        }
+    }
+    memcpy(out + k, a + i, (na - i) * sizeof(int));
+    memcpy(out + k + (na - i), b + j, (nb - j) * sizeof(int));
+}
+
+void adaptiveSort(int arr[], long n) {
+    if (n < 2) return;
+
+    int nthreads = omp_get_max_threads();
+    long max_runs = n / MIN_RUN + nthreads + 1;
+    long *run_end = (long*)malloc(max_runs * sizeof(long));   // per-thread slices, then compacted
+    long *bounds = (long*)malloc((max_runs + 1) * sizeof(long));
+    long *next = (long*)malloc((max_runs + 1) * sizeof(long));
+    long *thread_runs = (long*)calloc(nthreads + 1, sizeof(long));
+    int *buf = (int*)malloc(n * sizeof(int));
+    if (!run_end || !bounds || !next || !thread_runs || !buf) {
+        perror("Failed to allocate adaptive sort buffers");
+        exit(1);
+    }
+
+    // 1. Run detection (thread t records at most its chunk / MIN_RUN + 1 runs, from slot begin / MIN_RUN + t)
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int t = omp_get_thread_num(), team = omp_get_num_threads();
+        long begin = n * t / team, end = n * (t + 1) / team;
+        long *mine = run_end + begin / MIN_RUN + t;
+        long count = 0;
+
+        for (long i = begin; i < end; ) {
+            long j = i + 1;
+            if (j < end && arr[j] < arr[i]) {
+                while (j < end && arr[j] < arr[j - 1]) j++;
+                for (long l = i, r = j - 1; l < r; l++, r--) {
+                    int tmp = arr[l]; arr[l] = arr[r]; arr[r] = tmp;
+                }
+            } else {
+                while (j < end && arr[j] >= arr[j - 1]) j++;
+            }
+            if (j - i < MIN_RUN && j < end) {
+                j = i + MIN_RUN < end ? i + MIN_RUN : end;
+                insertionSort(arr + i, j - i);
+            }
+            mine[count++] = j;
+            i = j;
+        }
+        thread_runs[t + 1] = count;
+        #pragma omp barrier
+
+        #pragma omp single
+        {
+            long runs = 0;
+            bounds[0] = 0;
+            for (int u = 0; u < team; u++) {
+                long *theirs = run_end + (n * u / team) / MIN_RUN + u;
+                for (long r = 0; r < thread_runs[u + 1]; r++) bounds[++runs] = theirs[r];
+            }
+            thread_runs[0] = runs;
+        }
+    }
+    long runs = thread_runs[0];
+
+    // 2. + 3. Pairwise galloping merges until one run is left
+    int *src = arr, *dst = buf;
+    #pragma omp parallel num_threads(nthreads)
+    #pragma omp single
+    while (runs > 1) {
+        long next_runs = 0;
+        for (long r = 0; r < runs; r += 2) {
+            long lo = bounds[r], mid = bounds[r + 1], hi = r + 2 <= runs ? bounds[r + 2] : mid;
+            long len = hi - lo;
+            int parts = (int)(len * nthreads / n);
+            if (parts < 1) parts = 1;
+            for (int p = 0; p < parts; p++) {
+                #pragma omp task firstprivate(p, lo, mid, hi, len, parts)
+                {
+                    long k0 = len * p / parts, k1 = len * (p + 1) / parts;
+                    const int *a = src + lo, *b = src + mid;
+                    long i0 = coRank(k0, a, mid - lo, b, hi - mid), i1 = coRank(k1, a, mid - lo, b, hi - mid);
+                    mergeGallop(a + i0, i1 - i0, b + (k0 - i0), (k1 - i1) - (k0 - i0), dst + lo + k0);
+                }
+            }
+            next[next_runs++] = lo;
+        }
+        next[next_runs] = n;
+        #pragma omp taskwait
+
+        long *tb = bounds; bounds = next; next = tb;
+        runs = next_runs;
+        int *ts = src; src = dst; dst = ts;
+    }
+
+    if (src != arr) {
+        #pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (long i = 0; i < n; i++) arr[i] = src[i];
+    }
+    free(run_end); free(bounds); free(next); free(thread_runs); free(buf);
+}
+
+// Natural runs per key: counts where a descending stretch starts, so a late arrival counts once
+// and a whole reversed block also counts once. Decides whether sortInts uses adaptiveSort.
+double runRatio(const int arr[], long n) {
+    long breaks = 0;
+    #pragma omp parallel for reduction(+:breaks)
+    for (long i = 1; i < n; i++) breaks += arr[i] < arr[i - 1] && (i == 1 || arr[i - 1] >= arr[i - 2]);
+    return n > 1 ? (double)breaks / (double)(n - 1) : 0.0;
+}
+
+// --- Sort engine selection for int keys ---
+// Presorted input (few natural runs) goes to adaptiveSort. Otherwise radix sort:
+// its fixed four passes plus a parallel region per pass pay off from a few thousand keys, and
+// below RADIX_MIN the sequential comparison sort wins.
+void sortInts(int arr[], long n) {
+    if (n >= RADIX_MIN && runRatio(arr, n) <= ADAPTIVE_MAX_RUNS) {
+        adaptiveSort(arr, n);
+    } else if (n >= RADIX_MIN) {
+        radixSort(arr, n);
+    } else {
+        sequentialMergeSort(arr, n);
+    }
+}
+
+// --- Top-k selection: the k smallest (or largest) keys in sorted order, without a full sort ---
+// Each thread keeps a bounded max-heap (min-heap for largest) of the best k keys of its chunk;
+// most keys lose a single compare against the heap root, so the scan is O(n) in practice.
+// The P*k survivors are then sorted and the first k taken: O(n + P k log(P k)) overall.
+static inline int topBefore(int a, int b, int largest) {
+    return largest ? a > b : a < b;
+}
+
+// Restore the heap below slot i (root = the worst of the kept keys).
+static void topSiftDown(int heap[], int size, int i, int largest) {
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, worst = i;
+        if (l < size && topBefore(heap[worst], heap[l], largest)) worst = l;
+        if (r < size && topBefore(heap[worst], heap[r], largest)) worst = r;
+        if (worst == i) return;
+        int t = heap[i]; heap[i] = heap[worst]; heap[worst] = t;
+        i = worst;
+    }
+}
+
+// Writes min(k, n) keys to out (ascending for smallest, descending for largest). Returns the count.
+int topK(const int arr[], long n, int k, int largest, int out[]) {
+    if (k > n) k = (int)n;
+    if (k <= 0) return 0;
+
+    int nthreads = omp_get_max_threads();
+    int *cand = (int*)malloc((size_t)nthreads * k * sizeof(int));
+    int *cand_n = (int*)calloc(nthreads, sizeof(int));
+    if (!cand || !cand_n) {
+        perror("Failed to allocate top-k heaps");
+        exit(1);
+    }
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int t = omp_get_thread_num(), team = omp_get_num_threads();
+        long begin = n * t / team, end = n * (t + 1) / team;
+        int *heap = cand + (long)t * k;
+        int size = 0;
+
+        for (long i = begin; i < end; i++) {
+            int v = arr[i];
+            if (size < k) {
+                // Sift up
+                int c = size++;
+                heap[c] = v;
+                while (c > 0 && topBefore(heap[(c - 1) / 2], heap[c], largest)) {
+                    int p = (c - 1) / 2;
+                    int tmp = heap[p]; heap[p] = heap[c]; heap[c] = tmp;
+                    c = p;
+                }
+            } else if (topBefore(v, heap[0], largest)) {
+                heap[0] = v;
+                topSiftDown(heap, k, 0, largest);
+            }
+        }
+        cand_n[t] = size;
+    }
+
+    // Gather the survivors, sort them and keep the first k
+    long total = 0;
+    for (int t = 0; t < nthreads; t++) {
+        memmove(cand + total, cand + (long)t * k, cand_n[t] * sizeof(int));
+        total += cand_n[t];
+    }
+    sequentialMergeSort(cand, total);
+    for (int i = 0; i < k; i++) out[i] = largest ? cand[total - 1 - i] : cand[i];
+
+    free(cand);
+    free(cand_n);
+    return k;
+}
+
+// --- Check helpers for the large runs: order and content (sum is order-independent) ---
+int isSorted(const int arr[], long n) {
+    int sorted = 1;
+    #pragma omp parallel for reduction(&&:sorted)
+    for (long i = 1; i < n; i++) {
+        sorted = sorted && arr[i - 1] <= arr[i];
+    }
+    return sorted;
+}
+
+long long checksum(const int arr[], long n) {
+    long long sum = 0;
+    #pragma omp parallel for reduction(+:sum)
+    for (long i = 0; i < n; i++) sum += arr[i];
+    return sum;
+}
+
+// --- Time one sort engine on a fresh copy of data; returns the elapsed seconds ---
+typedef void (*SortFn)(int arr[], long n);
+
+double benchSort(const char *name, SortFn sort, const int data[], int work[], long n,
+                 long long expected_sum, double time_ref) {
+    memcpy(work, data, n * sizeof(int));
+    double start = omp_get_wtime();
+    sort(work, n);
+    double elapsed = omp_get_wtime() - start;
+
+    printf("%-24s %f s", name, elapsed);
+    if (time_ref > 0) printf(" (Speedup: %.2fx)", time_ref / elapsed);
+    printf(" [%s]\n", isSorted(work, n) && checksum(work, n) == expected_sum ? "sorted" : "NOT SORTED");
+    return elapsed;
+}
+
+// =======================================================
+// --- External (larger-than-RAM) sort ---
+// =======================================================
+// Files are raw arrays of native-endian int. Two phases, both double-buffered with OpenMP tasks:
+//   1. Run generation: read a chunk, sort it with sortInts (whole team), write it as a run file,
+//      while a task reads the next chunk into the other buffer.
+//   2. Streaming merge: every run has a window in memory plus a prefetch block. Each round merges
+//      all buffered keys <= the smallest "last buffered key" of the runs that still have data on
+//      disk (nothing later in any file can precede them), while tasks write the previous round's
+//      output and prefetch the next block of each run.
+// The I/O tasks run on a second thread of a 2-thread outer region; the sort's own parallel region
+// is nested inside it, so max_active_levels is raised to 2.
+
+typedef struct {
+    FILE *f;
+    long remaining_in_file;    // keys not yet read from disk
+    long pos, len;             // window: buffered keys are win[pos .. len)
+    int *win;                  // capacity 2 * block
+    int *next;                 // prefetch block (capacity block)
+    long next_n;               // keys in next (valid after the round's taskwait)
+} ExtRun;
+
+static void readBlock(ExtRun *run, long block) {
+    long want = run->remaining_in_file < block ? run->remaining_in_file : block;
+    run->next_n = (long)fread(run->next, sizeof(int), want, run->f);
+    run->remaining_in_file -= run->next_n;
+}
+
+static void writeAll(FILE *f, const int *buf, long n) {
+    if ((long)fwrite(buf, sizeof(int), n, f) != n) {
+        perror("External sort: write failed");
+        exit(1);
+    }
+}
+
+static void runPath(char *path, size_t size, const char *dir, int r) {
+    snprintf(path, size, "%s/sort_run_%d.bin", dir, r);
+}
+
+// Sort in_path into out_path using about mem_bytes of buffers; run files go to tmp_dir.
+// Returns 0 on success.
+int externalSort(const char *in_path, const char *out_path, const char *tmp_dir, long mem_bytes) {
+    char path[4096];
+    FILE *in = fopen(in_path, "rb");
+    if (!in) {
+        perror(in_path);
+        return -1;
+    }
+    fseek(in, 0, SEEK_END);
+    long total = ftell(in) / (long)sizeof(int);
+    fseek(in, 0, SEEK_SET);
+
+    int saved_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(2);
+
+    // --- Phase 1: run generation (two chunk buffers + the sorter's scratch of one chunk) ---
+    long chunk = mem_bytes / (3 * (long)sizeof(int));
+    if (chunk < 1024) chunk = 1024;
+    int *buf[2];
+    buf[0] = (int*)malloc(chunk * sizeof(int));
+    buf[1] = (int*)malloc(chunk * sizeof(int));
+    if (!buf[0] || !buf[1]) {
+        perror("External sort: chunk buffers");
+        exit(1);
+    }
+
+    double t0 = omp_get_wtime();
+    int runs = 0, cur = 0;
+    long cur_n = (long)fread(buf[cur], sizeof(int), chunk, in), next_n = 0;
+    #pragma omp parallel num_threads(2)
+    #pragma omp single
+    while (cur_n > 0) {
+        // Read the next chunk in the background...
+        #pragma omp task shared(next_n)
+        next_n = (long)fread(buf[1 - cur], sizeof(int), chunk, in);
+
+        // ...while this thread sorts the current one and writes it out
+        sortInts(buf[cur], cur_n);
+        runPath(path, sizeof(path), tmp_dir, runs);
+        FILE *out = fopen(path, "wb");
+        if (!out) {
+            perror(path);
+            exit(1);
+        }
+        writeAll(out, buf[cur], cur_n);
+        fclose(out);
+        runs++;
+
+        #pragma omp taskwait
+        cur = 1 - cur;
+        cur_n = next_n;
+    }
+    fclose(in);
+    free(buf[0]);
+    free(buf[1]);
+    double t1 = omp_get_wtime();
+    double mb = total * (double)sizeof(int) / (1024.0 * 1024.0);
+    printf("Phase 1 (run generation): %d runs of <= %ld keys, %f s, %.1f MB/s\n", runs, chunk, t1 - t0, mb / (t1 - t0));
+
+    // --- Phase 2: streaming k-way merge (per run 3 blocks; two output buffers of 2*runs blocks) ---
+    long block = mem_bytes / (7 * (long)(runs > 0 ? runs : 1) * (long)sizeof(int));
+    if (block < 1024) block = 1024;
+    ExtRun *rs = (ExtRun*)calloc(runs > 0 ? runs : 1, sizeof(ExtRun));
+    int *windows = (int*)malloc((long)runs * 2 * block * sizeof(int) + sizeof(int));
+    int *prefetch = (int*)malloc((long)runs * block * sizeof(int) + sizeof(int));
+    int *outbuf[2];
+    outbuf[0] = (int*)malloc((long)runs * 2 * block * sizeof(int) + sizeof(int));
+    outbuf[1] = (int*)malloc((long)runs * 2 * block * sizeof(int) + sizeof(int));
+    long *from = (long*)malloc(2 * (runs + 1) * sizeof(long));
+    FILE *out = fopen(out_path, "wb");
+    if (!rs || !windows || !prefetch || !outbuf[0] || !outbuf[1] || !from || !out) {
+        perror("External sort: merge buffers");
+        exit(1);
+    }
+    long *to = from + runs + 1;
+
+    for (int r = 0; r < runs; r++) {
+        runPath(path, sizeof(path), tmp_dir, r);
+        rs[r].f = fopen(path, "rb");
+        if (!rs[r].f) {
+            perror(path);
+            exit(1);
+        }
+        fseek(rs[r].f, 0, SEEK_END);
+        rs[r].remaining_in_file = ftell(rs[r].f) / (long)sizeof(int);
+        fseek(rs[r].f, 0, SEEK_SET);
+        rs[r].win = windows + (long)r * 2 * block;
+        rs[r].next = prefetch + (long)r * block;
+        // Prime: one block in the window, the following one in the prefetch buffer
+        readBlock(&rs[r], block);
+        memcpy(rs[r].win, rs[r].next, rs[r].next_n * sizeof(int));
+        rs[r].len = rs[r].next_n;
+        readBlock(&rs[r], block);
+    }
+
+    long written = 0, out_n[2] = {0, 0};
+    int ob = 0;
+    #pragma omp parallel num_threads(2)
+    #pragma omp single
+    for (;;) {
+        // Safe bound: the smallest last buffered key among runs that still have data outside memory
+        int have_bound = 0, bound = 0;
+        long buffered = 0;
+        for (int r = 0; r < runs; r++) {
+            buffered += rs[r].len - rs[r].pos;
+            if ((rs[r].next_n > 0 || rs[r].remaining_in_file > 0) && rs[r].len > rs[r].pos) {
+                int last = rs[r].win[rs[r].len - 1];
+                if (!have_bound || last < bound) bound = last;
+                have_bound = 1;
+            }
+        }
+        if (buffered == 0) break;
+
+        // Background I/O: write the previous round's output, prefetch blocks that were consumed
+        int prev = 1 - ob;
+        if (out_n[prev] > 0) {
+            #pragma omp task firstprivate(prev)
+            writeAll(out, outbuf[prev], out_n[prev]);
+        }
+        for (int r = 0; r < runs; r++) {
+            if (rs[r].next_n == 0 && rs[r].remaining_in_file > 0) {
+                #pragma omp task firstprivate(r)
+                readBlock(&rs[r], block);
+            }
+        }
+
+        // Merge everything <= bound from the windows
+        for (int r = 0; r < runs; r++) {
+            long base = (long)r * 2 * block;
+            long cut = have_bound ? upperBound(rs[r].win, rs[r].pos, rs[r].len, bound) : rs[r].len;
+            from[r] = base + rs[r].pos;
+            to[r] = base + cut;
+            rs[r].pos = cut;
+        }
+        long merged = 0;
+        for (int r = 0; r < runs; r++) merged += to[r] - from[r];
+        kWayMergeRange(windows, from, to, runs, outbuf[ob]);
+        out_n[ob] = merged;
+        written += merged;
+
+        #pragma omp taskwait
+        out_n[prev] = 0;
+
+        // Top up windows that fell below one block from their (now complete) prefetch
+        for (int r = 0; r < runs; r++) {
+            long left = rs[r].len - rs[r].pos;
+            if (left < block && rs[r].next_n > 0) {
+                memmove(rs[r].win, rs[r].win + rs[r].pos, left * sizeof(int));
+                memcpy(rs[r].win + left, rs[r].next, rs[r].next_n * sizeof(int));
+                rs[r].pos = 0;
+                rs[r].len = left + rs[r].next_n;
+                rs[r].next_n = 0;
+            }
+        }
+        ob = 1 - ob;
+    }
+    writeAll(out, outbuf[1 - ob], out_n[1 - ob]);
+    fclose(out);
+    double t2 = omp_get_wtime();
+    printf("Phase 2 (streaming merge): %d-way, blocks of %ld keys, %f s, %.1f MB/s\n", runs, block, t2 - t1,
+           written * (double)sizeof(int) / (1024.0 * 1024.0) / (t2 - t1));
+    printf("Total: %.1f MB in %f s, %.1f MB/s\n", mb, t2 - t0, mb / (t2 - t0));
+
+    for (int r = 0; r < runs; r++) {
+        fclose(rs[r].f);
+        runPath(path, sizeof(path), tmp_dir, r);
+        remove(path);
+    }
+    free(rs); free(windows); free(prefetch); free(outbuf[0]); free(outbuf[1]); free(from);
+    omp_set_max_active_levels(saved_levels);
+    return written == total ? 0 : -1;
+}
+
+// --- External sort mode: generate `count` random keys in dir, sort them with a mem_mb budget, verify ---
+int runExternal(const char *dir, long count, long mem_mb) {
+    char in_path[4096], out_path[4096];
+    snprintf(in_path, sizeof(in_path), "%s/sort_input.bin", dir);
+    snprintf(out_path, sizeof(out_path), "%s/sort_output.bin", dir);
+    printf("--- External Sort: %ld keys (%.1f MB), %ld MB memory budget, %d threads ---\n",
+           count, count * (double)sizeof(int) / (1024.0 * 1024.0), mem_mb, omp_get_max_threads());
+
+    // Input, written in blocks so generation itself stays within the budget
+    long block = 1 << 20;
+    int *tmp = (int*)malloc(block * sizeof(int));
+    FILE *f = fopen(in_path, "wb");
+    if (!tmp || !f) {
+        perror(in_path);
+        return 1;
+    }
+    long long expected_sum = 0;
+    for (long done = 0; done < count; done += block) {
+        long n = count - done < block ? count - done : block;
+        for (long i = 0; i < n; i++) {
+            tmp[i] = rand() - RAND_MAX / 2;
+            expected_sum += tmp[i];
+        }
+        writeAll(f, tmp, n);
+    }
+    fclose(f);
+
+    if (externalSort(in_path, out_path, dir, mem_mb * 1024 * 1024) != 0) {
+        printf("External sort FAILED\n");
+        return 1;
+    }
+
+    // Verify by streaming the output: ascending across block borders, same sum, same count
+    f = fopen(out_path, "rb");
+    if (!f) {
+        perror(out_path);
+        return 1;
+    }
+    long long sum = 0;
+    long seen = 0, n;
+    int sorted = 1, last = INT_MIN;
+    while ((n = (long)fread(tmp, sizeof(int), block, f)) > 0) {
+        for (long i = 0; i < n; i++) {
+            sorted = sorted && tmp[i] >= last;
+            last = tmp[i];
+            sum += tmp[i];
+        }
+        seen += n;
+    }
+    fclose(f);
+    free(tmp);
+    int ok = sorted && seen == count && sum == expected_sum;
+    printf("Output: %s\n", ok ? "sorted" : "NOT SORTED");
+    if (remove(in_path) != 0) {
+        perror(in_path);
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
+
+
+int main(int argc, char **argv) {
+    // External sort mode: merge DIR COUNT [mem_mb]
+    if (argc >= 4 && strcmp(argv[1], "--external") == 0) {
+        selectBaseCase();
+        srand(time(NULL));
+        return runExternal(argv[2], atol(argv[3]), argc > 4 ? atol(argv[4]) : EXT_MEM_MB);
+    }
 
-int main() {
     printf("--- Task 1: Merge Sort with Ordered Output (%d threads) ---\n", N_THREADS);
     
     // Seed random number generator
@@ -75,9 +929,12 @@ int main() {
 
     int arr[ARRAY_SIZE];
     double start_w, end_w;
+    long large_n = argc > 1 ? atol(argv[1]) : LARGE_SIZE;
+    int max_threads = omp_get_max_threads(); // configured count (OMP_NUM_THREADS), used by RUN 3
 
     // Set thread count
     omp_set_num_threads(N_THREADS);
+    selectBaseCase();
 
 
     // =======================================================
@@ -150,5 +1007,89 @@ int main() {
 
     printf("\nExpected: Run 1 prints in mixed order. Run 2 prints strictly Segment 1, 2, 3, 4.\n");
 
+    // The 4 sorted segments are merged in one pass by the k-way loser tree
+    long seg_bounds[N_THREADS + 1];
+    int merged[ARRAY_SIZE];
+    for (int i = 0; i <= N_THREADS; i++) seg_bounds[i] = (long)i * SEGMENT_SIZE;
+    parallelKWayMerge(arr, seg_bounds, N_THREADS, merged);
+    printf("\nK-way merged (%d segments): ", N_THREADS);
+    for (int i = 0; i < ARRAY_SIZE; i++) printf("%d ", merged[i]);
+    printf("\n");
+
+
+    // =======================================================
+    // --- RUN 3: Full Parallel Merge Sort (large array) ---
+    // =======================================================
+    // The segments above are never merged, so the array is not sorted and at most 4 threads work.
+    // Here the whole array is sorted by task-parallel recursion, merging all the way to the top.
+    if (large_n < 2) {
+        return 0;
+    }
+    omp_set_num_threads(max_threads);
+    printf("\n--- RUN 3: Full Parallel Merge Sort (%ld elements, %d threads) ---\n", large_n, max_threads);
+
+    int *data = (int*)malloc(large_n * sizeof(int));
+    int *work = (int*)malloc(large_n * sizeof(int));
+    if (!data || !work) {
+        perror("Failed to allocate large array");
+        return 1;
+    }
+    for (long i = 0; i < large_n; i++) {
+        data[i] = rand() - RAND_MAX / 2; // negative keys too, to exercise the radix sign flip
+    }
+    long long expected_sum = checksum(data, large_n);
+
+    // Speedups are relative to the sequential merge sort
+    double time_seq = benchSort("Sequential mergeSort:", sequentialMergeSort, data, work, large_n, expected_sum, 0);
+    benchSort("Parallel mergeSort:", parallelMergeSort, data, work, large_n, expected_sum, time_seq);
+    benchSort("Segments + k-way merge:", segmentSort, data, work, large_n, expected_sum, time_seq);
+    benchSort("Parallel radixSort:", radixSort, data, work, large_n, expected_sum, time_seq);
+    double time_sort = benchSort("sortInts (auto):", sortInts, data, work, large_n, expected_sum, time_seq);
+
+
+    // =======================================================
+    // --- RUN 4: Top-k Selection (no full sort) ---
+    // =======================================================
+    // work is fully sorted now, so its two ends are the reference answers.
+    int top[TOP_K];
+    int k = large_n < TOP_K ? (int)large_n : TOP_K;
+    printf("\n--- RUN 4: Top-%d Selection (%ld elements, %d threads) ---\n", k, large_n, max_threads);
+
+    start_w = omp_get_wtime();
+    topK(data, large_n, k, 0, top);
+    end_w = omp_get_wtime();
+    int ok = memcmp(top, work, k * sizeof(int)) == 0;
+    printf("Smallest %d: %f s (Speedup vs. full sort: %.1fx) [%s]\n", k, end_w - start_w,
+           time_sort / (end_w - start_w), ok ? "correct" : "WRONG");
+
+    start_w = omp_get_wtime();
+    topK(data, large_n, k, 1, top);
+    end_w = omp_get_wtime();
+    ok = 1;
+    for (int i = 0; i < k; i++) ok = ok && top[i] == work[large_n - 1 - i];
+    printf("Largest %d:  %f s (Speedup vs. full sort: %.1fx) [%s]\n", k, end_w - start_w,
+           time_sort / (end_w - start_w), ok ? "correct" : "WRONG");
+
+
+    // =======================================================
+    // --- RUN 5: Nearly Sorted Input (sorted log with late arrivals) ---
+    // =======================================================
+    // Timestamps in order, except that 0.1% of the records arrive late (an earlier timestamp),
+    // plus one block appended in reverse order. sortInts detects this and uses adaptiveSort.
+    for (long i = 0; i < large_n; i++) {
+        data[i] = (int)(i * 4);
+        if (rand() % 1000 == 0) data[i] -= rand() % 100000;
+    }
+    for (long i = large_n - large_n / 100; i < large_n; i++) data[i] = (int)((large_n - i) * 4);
+    expected_sum = checksum(data, large_n);
+    printf("\n--- RUN 5: Nearly Sorted Input (%ld elements, %.3f%% run breaks, %d threads) ---\n",
+           large_n, 100.0 * runRatio(data, large_n), max_threads);
+
+    time_seq = benchSort("Sequential mergeSort:", sequentialMergeSort, data, work, large_n, expected_sum, 0);
+    benchSort("Parallel radixSort:", radixSort, data, work, large_n, expected_sum, time_seq);
+    benchSort("Adaptive (runs+gallop):", adaptiveSort, data, work, large_n, expected_sum, time_seq);
+    benchSort("sortInts (auto):", sortInts, data, work, large_n, expected_sum, time_seq);
+
+    free(data); free(work);
     return 0;
 }
\ No newline at end of file
@@ -2,9 +2,70 @@
 #include <omp.h>
 #include <stdlib.h>
 #include <algorithm> // For std::sort
+#include <type_traits> // For the key-type test in sortAuto
+#include <vector>
+#include <functional> // For std::less / std::greater
+#include <memory> // For std::unique_ptr (move-only elements)
+#include <string>
+#include "parallel_sort.hpp" // parallel_sort, parallel_stable_sort, parallel_stable_sort_by_key
+#include "sort_engines.h" // radixSortKeys, loser-tree k-way merge, multiCoRank
+#include <stdint.h>
+#include <string.h>
 
 #define ARRAY_SIZE 16
 #define SEGMENT_SIZE (ARRAY_SIZE / 4)
+// Large-array engine comparison (RUN 3)
+#define N_LARGE 10000000L
+// Size from which sortAuto prefers radixSort (sort_engines.h) over std::sort.
+#define RADIX_MIN 4096
+// Segment sort (k-way merge engine): independently sorted segments per thread.
+#define SEGMENTS_PER_THREAD 4
+// Top-k selection: how many smallest keys RUN 3 extracts without a full sort.
+#define TOP_K 100
+// Elements in the non-trivially-movable (std::string) and move-only (std::unique_ptr) checks (RUN 3).
+#define N_STRINGS 1000000L
+
+// --- Parallel LSD radix sort for 32-bit integer keys (signed or unsigned) ---
+// The digit passes run on the raw key bits in radixSortKeys (sort_engines.h); for signed T the
+// sign bit is flipped so negative keys order first.
+template <typename T>
+void radixSort(T *arr, long n) {
+    static_assert(std::is_integral<T>::value && sizeof(T) == 4, "radixSort needs 32-bit integer keys");
+    radixSortKeys(reinterpret_cast<uint32_t*>(arr), n, std::is_signed<T>::value ? 0x80000000u : 0u);
+}
+
+// --- Sort engine selection: radix for large arrays of 32-bit integer keys, parallel_sort otherwise ---
+// The key-type test is resolved at compile time, so radixSort is only instantiated where it applies.
+template <typename T>
+void sortAutoImpl(T *arr, long n, std::true_type /* radix-able key */) {
+    if (n >= RADIX_MIN) radixSort(arr, n);
+    else std::sort(arr, arr + n);
+}
+
+template <typename T>
+void sortAutoImpl(T *arr, long n, std::false_type) {
+    parallel_sort(arr, arr + n); // falls back to std::sort below PARALLEL_SORT_MIN
+}
+
+template <typename T>
+void sortAuto(T *arr, long n) {
+    sortAutoImpl(arr, n, std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) == 4>());
+}
+
+// --- Segment sort: std::sort SEGMENTS_PER_THREAD segments per thread independently, then k-way merge ---
+// The k-way merge is the loser-tree engine from sort_engines.h.
+void segmentSort(int *arr, long n) {
+    int k = (int)std::min<long>(omp_get_max_threads() * SEGMENTS_PER_THREAD, std::max(n, 1L));
+    std::vector<long> bounds(k + 1);
+    for (int r = 0; r <= k; r++) bounds[r] = n * r / k;
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int r = 0; r < k; r++) std::sort(arr + bounds[r], arr + bounds[r + 1]);
+
+    std::vector<int> out(n);
+    parallelKWayMerge(arr, bounds.data(), k, out.data());
+    std::copy(out.begin(), out.end(), arr);
+}
 
 int main() {
     printf("--- TASK 1: Merge Sort Simulation with Ordered Output ---\n");
@@ -18,6 +79,7 @@ int main() {
     for(int i=0; i < ARRAY_SIZE; i++) printf("%d ", arr[i]);
     printf("\n\n");
 
+    int default_threads = omp_get_max_threads(); // OMP_NUM_THREADS, or every core; used by Run 3
     omp_set_num_threads(4);
     
     // --- Run 1: Without ordered (Random Output Order) ---
@@ -65,6 +127,155 @@ int main() {
     printf("Run 1 (Without ordered) shows segments printed in random order.\n");
     printf("Run 2 (With ordered) shows segments printed in correct order (Segment 1, 2, 3, 4).\n");
 
+    // The 4 sorted segments are merged in one pass by the k-way loser tree
+    long seg_bounds[5] = {0, SEGMENT_SIZE, 2 * SEGMENT_SIZE, 3 * SEGMENT_SIZE, ARRAY_SIZE};
+    int merged[ARRAY_SIZE];
+    parallelKWayMerge(arr, seg_bounds, 4, merged);
+    printf("\nK-way merged (4 segments): ");
+    for (int i = 0; i < ARRAY_SIZE; i++) printf("%d ", merged[i]);
+    printf("\n");
+
+
+    // --- Run 3: Sort engines on a large array ---
+    // The segments above are only sorted locally and use 4 threads. These engines sort the whole
+    // array with the default team (OMP_NUM_THREADS if set). std::sort is the baseline; sortAuto
+    // picks radix for these int keys.
+    omp_set_num_threads(default_threads);
+    printf("\n--- RUN 3: Sort Engines on %ld Elements (%d threads) ---\n", N_LARGE, omp_get_max_threads());
+
+    int *data = (int*)malloc(N_LARGE * sizeof(int));
+    int *work = (int*)malloc(N_LARGE * sizeof(int));
+    if (!data || !work) {
+        perror("Failed to allocate large array");
+        return 1;
+    }
+    srand(42);
+    for (long i = 0; i < N_LARGE; i++) data[i] = rand() - RAND_MAX / 2;
+
+    memcpy(work, data, N_LARGE * sizeof(int));
+    double start = omp_get_wtime();
+    std::sort(work, work + N_LARGE);
+    double time_std = omp_get_wtime() - start;
+    printf("std::sort:         %f s [%s]\n", time_std, std::is_sorted(work, work + N_LARGE) ? "sorted" : "NOT SORTED");
+
+    memcpy(work, data, N_LARGE * sizeof(int));
+    start = omp_get_wtime();
+    segmentSort(work, N_LARGE);
+    double time_seg = omp_get_wtime() - start;
+    printf("segmentSort:       %f s (Speedup: %.2fx) [%s]\n", time_seg, time_std / time_seg,
+           std::is_sorted(work, work + N_LARGE) ? "sorted" : "NOT SORTED");
+
+    memcpy(work, data, N_LARGE * sizeof(int));
+    start = omp_get_wtime();
+    parallel_sort(work, work + N_LARGE);
+    double time_sample = omp_get_wtime() - start;
+    printf("parallel_sort:     %f s (Speedup: %.2fx) [%s]\n", time_sample, time_std / time_sample,
+           std::is_sorted(work, work + N_LARGE) ? "sorted" : "NOT SORTED");
+
+    memcpy(work, data, N_LARGE * sizeof(int));
+    start = omp_get_wtime();
+    radixSort(work, N_LARGE);
+    double time_radix = omp_get_wtime() - start;
+    printf("radixSort:         %f s (Speedup: %.2fx) [%s]\n", time_radix, time_std / time_radix,
+           std::is_sorted(work, work + N_LARGE) ? "sorted" : "NOT SORTED");
+
+    memcpy(work, data, N_LARGE * sizeof(int));
+    start = omp_get_wtime();
+    sortAuto(work, N_LARGE);
+    double time_auto = omp_get_wtime() - start;
+    printf("sortAuto<int>:     %f s (Speedup: %.2fx) [%s]\n", time_auto, time_std / time_auto,
+           std::is_sorted(work, work + N_LARGE) ? "sorted" : "NOT SORTED");
+
+    // Top-k: only the TOP_K smallest, sorted; work (fully sorted) holds the reference answer
+    int top[TOP_K];
+    start = omp_get_wtime();
+    parallel_partial_sort_copy(data, data + N_LARGE, top, top + TOP_K);
+    double time_top = omp_get_wtime() - start;
+    printf("top-%d (partial):  %f s (Speedup: %.2fx) [%s]\n", TOP_K, time_top, time_std / time_top,
+           std::equal(top, top + TOP_K, work) ? "correct" : "WRONG");
+
+    // The header sorts are generic: the same keys as doubles, in descending order
+    double *keys = (double*)malloc(N_LARGE * sizeof(double));
+    if (!keys) {
+        perror("Failed to allocate large array");
+        return 1;
+    }
+    for (long i = 0; i < N_LARGE; i++) keys[i] = data[i] * 0.5;
+    start = omp_get_wtime();
+    parallel_sort(keys, keys + N_LARGE, std::greater<double>());
+    double time_desc = omp_get_wtime() - start;
+    printf("parallel_sort<double, greater>: %f s [%s]\n", time_desc,
+           std::is_sorted(keys, keys + N_LARGE, std::greater<double>()) ? "sorted" : "NOT SORTED");
+    free(keys);
+
+    // Key + payload records: stable sort by a small key range, so equal keys must keep the
+    // original (payload) order
+    struct Record {
+        int key;
+        long payload;
+    };
+    std::vector<Record> records(N_LARGE);
+    for (long i = 0; i < N_LARGE; i++) records[i] = Record{data[i] & 1023, i};
+    start = omp_get_wtime();
+    parallel_stable_sort(records.begin(), records.end(), [](const Record &a, const Record &b) { return a.key < b.key; });
+    double time_stable = omp_get_wtime() - start;
+    bool stable = true;
+    for (long i = 1; i < N_LARGE; i++) {
+        const Record &a = records[i - 1], &b = records[i];
+        stable = stable && (a.key < b.key || (a.key == b.key && a.payload < b.payload));
+    }
+    printf("parallel_stable_sort<Record>:   %f s [%s]\n", time_stable, stable ? "sorted, stable" : "NOT STABLE");
+
+    // Same ordering through separate key and value vectors
+    std::vector<int> sort_keys(N_LARGE);
+    std::vector<long> sort_values(N_LARGE);
+    for (long i = 0; i < N_LARGE; i++) {
+        sort_keys[i] = data[i] & 1023;
+        sort_values[i] = i;
+    }
+    start = omp_get_wtime();
+    parallel_stable_sort_by_key(sort_keys, sort_values);
+    double time_by_key = omp_get_wtime() - start;
+    stable = true;
+    for (long i = 0; i < N_LARGE; i++) {
+        stable = stable && sort_keys[i] == records[i].key && sort_values[i] == records[i].payload;
+    }
+    printf("parallel_stable_sort_by_key:    %f s [%s]\n", time_by_key, stable ? "sorted, stable" : "NOT STABLE");
+
+    // std::string elements: moving one empties the source, so an engine that reads an element
+    // after a sibling task moved it out shows up here. Strings are longer than the small-string
+    // buffer, and ordered by their 4-digit key prefix only, so stability is checked as well.
+    std::vector<std::string> strings(N_STRINGS);
+    char text[64];
+    for (long i = 0; i < N_STRINGS; i++) {
+        snprintf(text, sizeof(text), "%04d-payload-%08ld", data[i] & 1023, i);
+        strings[i] = text;
+    }
+    std::vector<std::string> expected(strings);
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const std::string &a, const std::string &b) { return a.compare(0, 4, b, 0, 4) < 0; });
+    start = omp_get_wtime();
+    parallel_stable_sort(strings.begin(), strings.end(),
+                         [](const std::string &a, const std::string &b) { return a.compare(0, 4, b, 0, 4) < 0; });
+    double time_strings = omp_get_wtime() - start;
+    printf("parallel_stable_sort<string>:   %f s [%s]\n", time_strings,
+           strings == expected ? "sorted, stable" : "WRONG ORDER");
+
+    // Move-only elements: neither engine may copy (splitters, scratch buffer)
+    std::vector<std::unique_ptr<int> > boxes(N_STRINGS);
+    for (long i = 0; i < N_STRINGS; i++) boxes[i].reset(new int(data[i]));
+    auto box_less = [](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) { return *a < *b; };
+    start = omp_get_wtime();
+    parallel_sort(boxes.begin(), boxes.end(), box_less);
+    double time_boxes = omp_get_wtime() - start;
+    bool boxes_ok = std::is_sorted(boxes.begin(), boxes.end(), box_less);
+    for (long i = 0; i < N_STRINGS; i++) *boxes[i] = -*boxes[i];
+    parallel_stable_sort(boxes.begin(), boxes.end(), box_less);
+    boxes_ok = boxes_ok && std::is_sorted(boxes.begin(), boxes.end(), box_less);
+    printf("parallel_sort<unique_ptr>:      %f s [%s]\n", time_boxes,
+           boxes_ok ? "sorted, stable sort too" : "NOT SORTED");
+
+    free(data); free(work);
     return 0;
 }
 
@@ -86,8 +297,10 @@ int main() {
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <omp.h>
 #include <time.h> // For timing
+#include "csr.h"
 
 #define N_MAT 4 // Size 4x4
 
@@ -168,6 +381,18 @@ int main() {
     printf("Run 1 (Without ordered) shows results in random thread completion order.\n");
     printf("Run 2 (With ordered) prints elements strictly in row-major order (0,0 -> 0,1 ... -> 3,3).\n");
 
+    // --- Run 3: Density-routed multiply ---
+    // B above is the identity: the dense loops did all N^3 multiplies anyway. matMulAuto checks
+    // operand density first and sends sparse operands through the CSR engine.
+    printf("\n--- RUN 3: Density-Routed Multiply (sparse operands use CSR) ---\n");
+    const char *path = matMulAuto(&A[0][0], &B[0][0], &C[0][0], N_MAT, N_MAT, N_MAT);
+    printf("Path: %s\n", path);
+    for (int i = 0; i < N_MAT; i++) {
+        for (int j = 0; j < N_MAT; j++) printf("%d ", C[i][j]);
+        printf("\n");
+    }
+    runSparse();
+
     return 0;
 }
 
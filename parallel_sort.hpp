@@ -0,0 +1,327 @@
+// parallel_sort.hpp - header-only parallel sorts on top of OpenMP.
+//
+//   parallel_sort(first, last [, comp])               unstable, sample sort
+//   parallel_stable_sort(first, last [, comp])        stable, chunked merge sort
+//   parallel_stable_sort_by_key(keys, values [, comp]) reorder two parallel vectors by key
+//                                                      (same size, else std::invalid_argument)
+//   parallel_partial_sort_copy(first, last, d_first, d_last [, comp])  top-k, sorted, into d_first
+//
+// The sorts only ever move elements (std::move / move iterators), never copy them: splitters are
+// referred to by index, and the scratch buffer is raw storage that elements are move-constructed
+// into. So parallel_sort and parallel_stable_sort need T to be move-constructible and
+// move-assignable only - move-only types such as std::unique_ptr work. parallel_stable_sort_by_key
+// also needs default-constructible K and V; parallel_partial_sort_copy copies, like
+// std::partial_sort_copy.
+#ifndef PARALLEL_SORT_HPP
+#define PARALLEL_SORT_HPP
+
+#include <omp.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Inputs smaller than this are handed to std::sort / std::stable_sort directly.
+#ifndef PARALLEL_SORT_MIN
+#define PARALLEL_SORT_MIN 16384
+#endif
+// Samples drawn per bucket when choosing the sample sort splitters.
+#ifndef PARALLEL_SORT_OVERSAMPLE
+#define PARALLEL_SORT_OVERSAMPLE 64
+#endif
+
+namespace parallel_sort_detail {
+
+// Merge path (co-ranking): how many of the first k outputs of a stable merge of a[0..na) and
+// b[0..nb) come from a. On equal keys a comes first.
+template <typename It, typename Compare>
+long coRank(long k, It a, long na, It b, long nb, Compare comp) {
+    long lo = k > nb ? k - nb : 0;
+    long hi = k < na ? k : na;
+    while (lo < hi) {
+        long i = lo + (hi - lo) / 2;
+        if (!comp(b[k - i - 1], a[i])) lo = i + 1; // a[i] is among the first k
+        else hi = i;
+    }
+    return lo;
+}
+
+// Stable-merge (by moving) src[lo..mid) and src[mid..hi) into dst[lo..hi), split into `parts`
+// independent slices by merge path. Must run inside a parallel region; each slice is a task.
+// All split points are co-ranked before the first task starts: a slice moves its elements out of
+// src, so a later co-rank could otherwise compare against an already moved-from element.
+template <typename SrcIt, typename DstIt, typename Compare>
+void mergeSlices(SrcIt src, DstIt dst, long lo, long mid, long hi, int parts, Compare comp) {
+    long na = mid - lo, nb = hi - mid, n = hi - lo;
+    std::vector<long> split(parts + 1);
+    for (int p = 0; p <= parts; p++) split[p] = coRank(n * p / parts, src + lo, na, src + mid, nb, comp);
+    for (int p = 0; p < parts; p++) {
+        long k0 = n * p / parts, k1 = n * (p + 1) / parts;
+        long i0 = split[p], i1 = split[p + 1];
+        #pragma omp task firstprivate(k0, k1, i0, i1)
+        {
+            std::merge(std::make_move_iterator(src + lo + i0), std::make_move_iterator(src + lo + i1),
+                       std::make_move_iterator(src + mid + (k0 - i0)), std::make_move_iterator(src + mid + (k1 - i1)),
+                       dst + lo + k0, comp);
+        }
+    }
+}
+
+// Uninitialized storage for n elements of T. Every slot is move-constructed exactly once through
+// construct() (possibly from several threads, on distinct slots) and all n are destroyed with the
+// buffer, so T needs no default constructor.
+template <typename T>
+class ScratchBuffer {
+public:
+    explicit ScratchBuffer(long n) : data_(static_cast<T*>(::operator new(sizeof(T) * n))), n_(n) {}
+    ~ScratchBuffer() {
+        for (long i = 0; i < n_; i++) data_[i].~T();
+        ::operator delete(data_);
+    }
+    T *begin() { return data_; }
+    void construct(long i, T &&v) { ::new (static_cast<void*>(data_ + i)) T(std::move(v)); }
+
+private:
+    ScratchBuffer(const ScratchBuffer &);
+    ScratchBuffer &operator=(const ScratchBuffer &);
+    T *data_;
+    long n_;
+};
+
+} // namespace parallel_sort_detail
+
+// =======================================================
+// --- parallel_sort: sample sort (not stable) ---
+// =======================================================
+// 1. P-1 splitters from an oversampled, regularly strided sample (P = thread count). Samples and
+//    splitters are indices into the range, which is not modified until every element is classified.
+// 2. Each thread classifies its static chunk against the splitters and counts per bucket.
+// 3. Bucket-major, thread-minor prefix sums give every (thread, bucket) its own output range,
+//    so the scatter (a move into the scratch buffer) needs no atomics.
+// 4. Buckets are sorted independently with std::sort and moved back.
+// Heavy duplicates of one splitter value can unbalance the buckets.
+template <typename RandomIt, typename Compare>
+void parallel_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    long n = last - first;
+    int nthreads = omp_get_max_threads();
+    int buckets = nthreads;
+    if (buckets < 2 || n < PARALLEL_SORT_MIN) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // 1. Splitters, as positions in [first, last)
+    long n_samples = (long)buckets * PARALLEL_SORT_OVERSAMPLE;
+    long stride = n / n_samples;
+    std::vector<long> samples(n_samples);
+    for (long s = 0; s < n_samples; s++) samples[s] = s * stride + stride / 2;
+    std::sort(samples.begin(), samples.end(), [&](long a, long b) { return comp(first[a], first[b]); });
+    std::vector<long> splitters;
+    for (int b = 1; b < buckets; b++) splitters.push_back(samples[(long)b * PARALLEL_SORT_OVERSAMPLE]);
+    // upper_bound(value): is value ordered before the splitter at position s?
+    auto before_splitter = [&](const T &value, long s) { return comp(value, first[s]); };
+
+    std::vector<int> bucket_of(n);
+    std::vector<long> offsets((size_t)nthreads * buckets, 0);
+    std::vector<long> bucket_start(buckets + 1, 0);
+    parallel_sort_detail::ScratchBuffer<T> tmp(n);
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int t = omp_get_thread_num(), team = omp_get_num_threads();
+        long begin = n * t / team, end = n * (t + 1) / team;
+        long *count = &offsets[(size_t)t * buckets];
+
+        // 2. Classify and count
+        for (long i = begin; i < end; i++) {
+            int b = (int)(std::upper_bound(splitters.begin(), splitters.end(), first[i], before_splitter) -
+                          splitters.begin());
+            bucket_of[i] = b;
+            count[b]++;
+        }
+        #pragma omp barrier
+
+        // 3. Per-(thread, bucket) output offsets, then scatter
+        #pragma omp single
+        {
+            long offset = 0;
+            for (int b = 0; b < buckets; b++) {
+                bucket_start[b] = offset;
+                for (int u = 0; u < team; u++) {
+                    long c = offsets[(size_t)u * buckets + b];
+                    offsets[(size_t)u * buckets + b] = offset;
+                    offset += c;
+                }
+            }
+            bucket_start[buckets] = offset;
+        }
+
+        for (long i = begin; i < end; i++) tmp.construct(count[bucket_of[i]]++, std::move(first[i]));
+        #pragma omp barrier
+
+        // 4. Sort buckets independently (dynamic: buckets differ in size) and move back
+        #pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < buckets; b++) {
+            std::sort(tmp.begin() + bucket_start[b], tmp.begin() + bucket_start[b + 1], comp);
+            std::move(tmp.begin() + bucket_start[b], tmp.begin() + bucket_start[b + 1], first + bucket_start[b]);
+        }
+    }
+}
+
+template <typename RandomIt>
+void parallel_sort(RandomIt first, RandomIt last) {
+    parallel_sort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+// =======================================================
+// --- parallel_stable_sort: chunked merge sort (stable) ---
+// =======================================================
+// Each thread moves one chunk into the scratch buffer and std::stable_sorts it there, then rounds
+// of pairwise merges halve the number of runs, moving between the buffer and the range
+// (ping-pong). Every merge is split by merge path so the last rounds, with fewer runs than
+// threads, still use the whole team.
+template <typename RandomIt, typename Compare>
+void parallel_stable_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    long n = last - first;
+    int nthreads = omp_get_max_threads();
+    if (nthreads < 2 || n < PARALLEL_SORT_MIN) {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+
+    std::vector<long> bounds(nthreads + 1);
+    for (int r = 0; r <= nthreads; r++) bounds[r] = n * r / nthreads;
+    parallel_sort_detail::ScratchBuffer<T> buf(n);
+    bool in_buf = true; // where the current runs live
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        #pragma omp for schedule(static, 1)
+        for (int r = 0; r < nthreads; r++) {
+            for (long i = bounds[r]; i < bounds[r + 1]; i++) buf.construct(i, std::move(first[i]));
+            std::stable_sort(buf.begin() + bounds[r], buf.begin() + bounds[r + 1], comp);
+        }
+
+        #pragma omp single
+        {
+            while (bounds.size() > 2) {
+                std::vector<long> next;
+                for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+                    long lo = bounds[r];
+                    long mid = bounds[r + 1];
+                    long hi = r + 2 < bounds.size() ? bounds[r + 2] : mid;
+                    // Slices in proportion to this merge's share of the whole array
+                    int parts = (int)std::max(1L, (hi - lo) * nthreads / n);
+                    if (in_buf) parallel_sort_detail::mergeSlices(buf.begin(), first, lo, mid, hi, parts, comp);
+                    else parallel_sort_detail::mergeSlices(first, buf.begin(), lo, mid, hi, parts, comp);
+                    next.push_back(lo);
+                }
+                next.push_back(n);
+                #pragma omp taskwait
+                bounds.swap(next);
+                in_buf = !in_buf;
+            }
+        }
+
+        if (in_buf) {
+            #pragma omp for schedule(static)
+            for (long i = 0; i < n; i++) first[i] = std::move(buf.begin()[i]);
+        }
+    }
+}
+
+template <typename RandomIt>
+void parallel_stable_sort(RandomIt first, RandomIt last) {
+    parallel_stable_sort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+// =======================================================
+// --- parallel_stable_sort_by_key: sort values by a parallel vector of keys ---
+// =======================================================
+// A permutation of indices is stable-sorted by key, then both vectors are gathered through it in
+// parallel: every key and value is moved exactly once. Equal keys keep their original order.
+// Throws std::invalid_argument (before touching either vector) if the sizes differ.
+template <typename K, typename V, typename Compare>
+void parallel_stable_sort_by_key(std::vector<K> &keys, std::vector<V> &values, Compare comp) {
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("parallel_stable_sort_by_key: keys and values differ in size");
+    }
+    long n = (long)keys.size();
+    std::vector<long> perm(n);
+    std::iota(perm.begin(), perm.end(), 0L);
+    parallel_stable_sort(perm.begin(), perm.end(), [&](long a, long b) { return comp(keys[a], keys[b]); });
+
+    std::vector<K> sorted_keys(n);
+    std::vector<V> sorted_values(n);
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < n; i++) {
+        sorted_keys[i] = std::move(keys[perm[i]]);
+        sorted_values[i] = std::move(values[perm[i]]);
+    }
+    keys.swap(sorted_keys);
+    values.swap(sorted_values);
+}
+
+template <typename K, typename V>
+void parallel_stable_sort_by_key(std::vector<K> &keys, std::vector<V> &values) {
+    parallel_stable_sort_by_key(keys, values, std::less<K>());
+}
+
+// =======================================================
+// --- parallel_partial_sort_copy: top-k selection ---
+// =======================================================
+// Same contract as std::partial_sort_copy: the k = min(n, d_last - d_first) smallest elements
+// (by comp) are copied to d_first in sorted order and the input is left untouched. Each thread
+// keeps a bounded heap of its best k (most elements lose one compare against the heap top), then
+// the P*k survivors are partially sorted: O(n + P k log k) instead of a full O(n log n) sort.
+template <typename RandomIt, typename OutIt, typename Compare>
+OutIt parallel_partial_sort_copy(RandomIt first, RandomIt last, OutIt d_first, OutIt d_last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    long n = last - first;
+    long k = std::min(n, (long)(d_last - d_first));
+    if (k <= 0) return d_first;
+    if (n < PARALLEL_SORT_MIN) return std::partial_sort_copy(first, last, d_first, d_first + k, comp);
+
+    int nthreads = omp_get_max_threads();
+    std::vector<std::vector<T> > heaps(nthreads);
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int t = omp_get_thread_num(), team = omp_get_num_threads();
+        long begin = n * t / team, end = n * (t + 1) / team;
+        std::vector<T> &heap = heaps[t]; // max-heap by comp: front() is the worst kept element
+        heap.reserve(k);
+
+        for (long i = begin; i < end; i++) {
+            if ((long)heap.size() < k) {
+                heap.push_back(first[i]);
+                std::push_heap(heap.begin(), heap.end(), comp);
+            } else if (comp(first[i], heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), comp);
+                heap.back() = first[i];
+                std::push_heap(heap.begin(), heap.end(), comp);
+            }
+        }
+    }
+
+    std::vector<T> candidates;
+    for (int t = 0; t < nthreads; t++) {
+        std::move(heaps[t].begin(), heaps[t].end(), std::back_inserter(candidates));
+    }
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(), comp);
+    return std::move(candidates.begin(), candidates.begin() + k, d_first);
+}
+
+template <typename RandomIt, typename OutIt>
+OutIt parallel_partial_sort_copy(RandomIt first, RandomIt last, OutIt d_first, OutIt d_last) {
+    return parallel_partial_sort_copy(first, last, d_first, d_last,
+                                      std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+#endif // PARALLEL_SORT_HPP
@@ -87,8 +87,66 @@ int main() {
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <omp.h>
 
+#define CACHE_LINE 64
+#define BENCH_INCREMENTS (1 << 22) // increments per benchmark measurement (split across threads)
+
+// --- Sharded counter: one cache-line-sized slot per thread ---
+// Each thread increments only its own slot, so no cache line is ever shared between writers and
+// the increment needs no locked read-modify-write: a relaxed load and store of a line that stays
+// in the owning core's cache. Reading sums the slots (a snapshot while increments are running,
+// exact once they have finished). Slots are indexed by omp_get_thread_num(), so the counter needs
+// at least as many slots as the (single, non-nested) team has threads.
+typedef struct {
+    long value;
+    char pad[CACHE_LINE - sizeof(long)]; // keep the next thread's slot off this cache line
+} CounterSlot;
+
+typedef struct {
+    int n_slots;
+    CounterSlot *slots;
+} ShardedCounter;
+
+int shardedCounterInit(ShardedCounter *c, int n_slots) {
+    c->n_slots = n_slots;
+    c->slots = (CounterSlot*)aligned_alloc(CACHE_LINE, n_slots * sizeof(CounterSlot));
+    if (!c->slots) return -1;
+    for (int s = 0; s < n_slots; s++) c->slots[s].value = 0;
+    return 0;
+}
+
+void shardedCounterFree(ShardedCounter *c) {
+    free(c->slots);
+}
+
+// The calling thread's slot: look it up once per parallel region, then add through it.
+CounterSlot *shardedCounterSlot(ShardedCounter *c) {
+    return &c->slots[omp_get_thread_num()];
+}
+
+// Owner-only add. The atomic read/write (relaxed, plain moves on x86) only keep a concurrent
+// shardedCounterRead from seeing a torn value.
+static inline void counterSlotAdd(CounterSlot *slot, long delta) {
+    long v;
+    #pragma omp atomic read
+    v = slot->value;
+    #pragma omp atomic write
+    slot->value = v + delta;
+}
+
+long shardedCounterRead(ShardedCounter *c) {
+    long sum = 0;
+    for (int s = 0; s < c->n_slots; s++) {
+        long v;
+        #pragma omp atomic read
+        v = c->slots[s].value;
+        sum += v;
+    }
+    return sum;
+}
+
 int main() {
     printf("--- TASK 3: Atomic Counter ---\n");
 
@@ -129,6 +187,114 @@ int main() {
     printf("Final counter (With atomic): %d (Expected: %d)\n", counter_with_atomic, TOTAL_EXPECTED);
     printf("Observation: The final counter is exactly %d (Correct Result).\n", TOTAL_EXPECTED);
 
+
+    // --- 3. Contention benchmark: one hot counter, 1-64 threads ---
+    // Every variant counts the same BENCH_INCREMENTS events (a byte array, so the loops cannot be
+    // folded into one addition); the table shows million increments/s. "shards, no pad" packs the
+    // per-thread slots next to each other (false sharing), to show that the 64-byte padding, not
+    // just the sharding, removes the cache-line bouncing.
+    unsigned char *events = (unsigned char*)malloc(BENCH_INCREMENTS);
+    if (!events) {
+        perror("Failed to allocate events");
+        return 1;
+    }
+    for (int i = 0; i < BENCH_INCREMENTS; i++) events[i] = 1;
+    printf("\n--- 3. Contention Benchmark (%d increments per run, M increments/s) ---\n", BENCH_INCREMENTS);
+    printf("%8s %12s %12s %12s %12s %15s\n", "threads", "atomic", "critical", "reduction", "sharded", "shards, no pad");
+
+    int thread_counts[] = {1, 2, 4, 8, 16, 32, 64};
+    for (int k = 0; k < 7; k++) {
+        int threads = thread_counts[k];
+        omp_set_num_threads(threads);
+        double t0, t[5];
+        long results[5];
+
+        long shared_atomic = 0;
+        t0 = omp_get_wtime();
+        #pragma omp parallel for
+        for (int i = 0; i < BENCH_INCREMENTS; i++) {
+            if (events[i]) {
+                #pragma omp atomic
+                shared_atomic++;
+            }
+        }
+        t[0] = omp_get_wtime() - t0;
+        results[0] = shared_atomic;
+
+        long shared_critical = 0;
+        t0 = omp_get_wtime();
+        #pragma omp parallel for
+        for (int i = 0; i < BENCH_INCREMENTS; i++) {
+            if (events[i]) {
+                #pragma omp critical
+                shared_critical++;
+            }
+        }
+        t[1] = omp_get_wtime() - t0;
+        results[1] = shared_critical;
+
+        long reduced = 0;
+        t0 = omp_get_wtime();
+        #pragma omp parallel for reduction(+:reduced)
+        for (int i = 0; i < BENCH_INCREMENTS; i++) {
+            if (events[i]) reduced++;
+        }
+        t[2] = omp_get_wtime() - t0;
+        results[2] = reduced;
+
+        ShardedCounter sharded;
+        if (shardedCounterInit(&sharded, threads) != 0) {
+            perror("Failed to allocate counter slots");
+            return 1;
+        }
+        t0 = omp_get_wtime();
+        #pragma omp parallel
+        {
+            CounterSlot *mine = shardedCounterSlot(&sharded);
+            #pragma omp for
+            for (int i = 0; i < BENCH_INCREMENTS; i++) {
+                if (events[i]) counterSlotAdd(mine, 1);
+            }
+        }
+        results[3] = shardedCounterRead(&sharded);
+        t[3] = omp_get_wtime() - t0;
+        shardedCounterFree(&sharded);
+
+        long *unpadded = (long*)calloc(threads, sizeof(long));
+        if (!unpadded) {
+            perror("Failed to allocate counter slots");
+            return 1;
+        }
+        t0 = omp_get_wtime();
+        #pragma omp parallel
+        {
+            long *mine = &unpadded[omp_get_thread_num()];
+            #pragma omp for
+            for (int i = 0; i < BENCH_INCREMENTS; i++) {
+                if (events[i]) {
+                    long v;
+                    #pragma omp atomic read
+                    v = *mine;
+                    #pragma omp atomic write
+                    *mine = v + 1;
+                }
+            }
+        }
+        results[4] = 0;
+        for (int s = 0; s < threads; s++) results[4] += unpadded[s];
+        t[4] = omp_get_wtime() - t0;
+        free(unpadded);
+
+        int ok = 1;
+        for (int v = 0; v < 5; v++) ok = ok && results[v] == BENCH_INCREMENTS;
+        printf("%8d %12.1f %12.1f %12.1f %12.1f %15.1f%s\n", threads, BENCH_INCREMENTS / t[0] / 1e6,
+               BENCH_INCREMENTS / t[1] / 1e6, BENCH_INCREMENTS / t[2] / 1e6, BENCH_INCREMENTS / t[3] / 1e6,
+               BENCH_INCREMENTS / t[4] / 1e6, ok ? "" : "  WRONG COUNT");
+    }
+    printf("Observation: atomic and critical degrade as threads are added (one hot cache line);\n");
+    printf("the padded sharded counter scales like reduction(+) but can be read at any time.\n");
+    free(events);
+
     return 0;
 }
 
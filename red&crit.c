@@ -91,10 +91,175 @@ int main() {
 #include <stdio.h>
 #include <omp.h>
 #include <limits.h>
+#include <stdlib.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 #define N_T3 20
+// Version C (fused SIMD kernel) runs on a large array: default size, override with the first argument.
+#define N_LARGE_T3 50000000L
+
+// --- Fused min/max/argmin/argmax ---
+// One pass over memory yields all four results. Ties go to the lowest index, so argmin/argmax are
+// the FIRST position of the extremum no matter how many threads or lanes took part.
+// Every partial result is seeded from a real element (never from INT_MAX/INT_MIN sentinels, which
+// would leave the index unset when the data itself is INT_MAX or INT_MIN); `count` is the number
+// of elements it covers, and a result with count == 0 is empty and ignored when combining.
+typedef struct {
+    int min, max;
+    long argmin, argmax;
+    long count;
+} MinMax;
+
+static const MinMax MINMAX_EMPTY = {0, 0, -1, -1, 0};
+
+// Merge two partial results (ties keep the lower index).
+MinMax minMaxCombine(MinMax a, MinMax b) {
+    if (b.count == 0) return a;
+    if (a.count == 0) return b;
+    a.count += b.count;
+    if (b.min < a.min || (b.min == a.min && b.argmin < a.argmin)) {
+        a.min = b.min;
+        a.argmin = b.argmin;
+    }
+    if (b.max > a.max || (b.max == a.max && b.argmax < a.argmax)) {
+        a.max = b.max;
+        a.argmax = b.argmax;
+    }
+    return a;
+}
 
-int main() {
+// Scalar kernel over A[lo..hi): seeded from A[lo], strict compares keep the first occurrence.
+MinMax minMaxScalar(const int *A, long lo, long hi) {
+    if (lo >= hi) return MINMAX_EMPTY;
+    MinMax r = {A[lo], A[lo], lo, lo, hi - lo};
+    for (long i = lo + 1; i < hi; i++) {
+        if (A[i] < r.min) { r.min = A[i]; r.argmin = i; }
+        if (A[i] > r.max) { r.max = A[i]; r.argmax = i; }
+    }
+    return r;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// AVX2 kernel: 8 lanes each track their own min/max and the index where it was seen. Each lane
+// is seeded from its first element (the first vector), then a compare mask selects both the new
+// value and its index (strict, so each lane keeps its first hit); the lanes are reduced with the
+// index tie-break at the end. Lane indices are 32-bit offsets from the start of a block of at
+// most 2^30 elements, so any array length works.
+__attribute__((target("avx2")))
+MinMax minMaxAvx2(const int *A, long lo, long hi) {
+    MinMax r = MINMAX_EMPTY;
+    const long block_max = 1L << 30;
+
+    for (long base = lo; base < hi; base += block_max) {
+        long len = hi - base < block_max ? hi - base : block_max;
+        long vec_end = len & ~7L;
+        long lane_count = vec_end / 8; // elements seen by each lane
+        if (lane_count == 0) {
+            r = minMaxCombine(r, minMaxScalar(A, base, base + len));
+            continue;
+        }
+
+        __m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), step = _mm256_set1_epi32(8);
+        __m256i vmin = _mm256_loadu_si256((const __m256i*)(A + base)), vmax = vmin;
+        __m256i imin = idx, imax = idx;
+        idx = _mm256_add_epi32(idx, step);
+
+        for (long i = 8; i < vec_end; i += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(A + base + i));
+            __m256i lt = _mm256_cmpgt_epi32(vmin, v);
+            __m256i gt = _mm256_cmpgt_epi32(v, vmax);
+            vmin = _mm256_blendv_epi8(vmin, v, lt);
+            imin = _mm256_blendv_epi8(imin, idx, lt);
+            vmax = _mm256_blendv_epi8(vmax, v, gt);
+            imax = _mm256_blendv_epi8(imax, idx, gt);
+            idx = _mm256_add_epi32(idx, step);
+        }
+
+        int lmin[8], lmax[8], limin[8], limax[8];
+        _mm256_storeu_si256((__m256i*)lmin, vmin);
+        _mm256_storeu_si256((__m256i*)lmax, vmax);
+        _mm256_storeu_si256((__m256i*)limin, imin);
+        _mm256_storeu_si256((__m256i*)limax, imax);
+        for (int l = 0; l < 8; l++) {
+            MinMax lane = {lmin[l], lmax[l], base + limin[l], base + limax[l], lane_count};
+            r = minMaxCombine(r, lane);
+        }
+        r = minMaxCombine(r, minMaxScalar(A, base + vec_end, base + len));
+    }
+    return r;
+}
+#endif
+
+typedef MinMax (*MinMaxKernel)(const int *A, long lo, long hi);
+
+// Pick the widest kernel the CPU supports (CPUID via the compiler builtin).
+MinMaxKernel selectMinMaxKernel(const char **name) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "AVX2";
+        return minMaxAvx2;
+    }
+#endif
+    *name = "scalar";
+    return minMaxScalar;
+}
+
+// Parallel driver: each thread runs the kernel over one static chunk, and the per-thread results
+// are combined in thread order afterwards (no critical section, deterministic tie-break).
+MinMax minMaxParallel(const int *A, long n, MinMaxKernel kernel) {
+    int nthreads = omp_get_max_threads();
+    MinMax *partial = (MinMax*)malloc(nthreads * sizeof(MinMax));
+    MinMax r = MINMAX_EMPTY;
+    if (!partial) {
+        perror("Failed to allocate partial results");
+        return r;
+    }
+
+    int team = 1;
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int t = omp_get_thread_num();
+        #pragma omp single
+        team = omp_get_num_threads();
+        partial[t] = kernel(A, n * t / team, n * (t + 1) / team);
+    }
+
+    for (int t = 0; t < team; t++) r = minMaxCombine(r, partial[t]);
+    free(partial);
+    return r;
+}
+
+// Edge-case check: the selected kernel must agree with the scalar one (all four results) on inputs
+// built from INT_MAX/INT_MIN, including all-equal arrays, at lengths around the vector width.
+// Returns the number of mismatches.
+int minMaxSelfTest(MinMaxKernel kernel) {
+    int A[67], failures = 0;
+    for (int pattern = 0; pattern < 6; pattern++) {
+        for (int n = 1; n <= 67; n++) {
+            for (int i = 0; i < n; i++) {
+                switch (pattern) {
+                    case 0: A[i] = INT_MAX; break;                          // all INT_MAX
+                    case 1: A[i] = INT_MIN; break;                          // all INT_MIN
+                    case 2: A[i] = 7; break;                                // all equal
+                    case 3: A[i] = (i % 8 == 0) ? INT_MAX : 0; break;       // INT_MAX in one lane only
+                    case 4: A[i] = (i % 8 == 3) ? INT_MIN : 0; break;       // INT_MIN in one lane only
+                    default: A[i] = (i % 3 == 0) ? INT_MAX : INT_MIN; break; // both extremes, repeated
+                }
+            }
+            MinMax s = minMaxScalar(A, 0, n), k = kernel(A, 0, n);
+            if (s.min != k.min || s.max != k.max || s.argmin != k.argmin || s.argmax != k.argmax ||
+                s.argmin < 0 || s.argmax < 0 || A[s.argmin] != s.min || A[s.argmax] != s.max) {
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char **argv) {
     printf("--- TASK 3: Minimum & Maximum of Array ---\n");
 
     int A[N_T3] = {15, 3, 8, 1, 10, 20, 5, 12, 18, 2, 19, 9, 7, 14, 4, 11, 17, 6, 16, 13};
@@ -141,6 +306,64 @@ int main() {
     printf("\nExpected Outcome: Both methods yield Min=1, Max=20.\n");
     printf("Reduction is faster because it avoids serialization (thread blocking).\n");
 
+    MinMax small = minMaxParallel(A, N_T3, minMaxScalar);
+    printf("Fused kernel: Min = %d at A[%ld], Max = %d at A[%ld]\n", small.min, small.argmin, small.max, small.argmax);
+
+    const char *kernel_name;
+    MinMaxKernel kernel = selectMinMaxKernel(&kernel_name);
+    int failures = minMaxSelfTest(kernel);
+    printf("Edge-case check (%s vs scalar, INT_MAX/INT_MIN/all-equal inputs): %s\n", kernel_name,
+           failures == 0 ? "PASS" : "FAIL");
+    if (failures != 0) return 1;
+
+
+    // --- Version C: Fused SIMD kernel on a large array ---
+    // Version A needs two reduction variables and still cannot say WHERE the extremum is.
+    long n = argc > 1 ? atol(argv[1]) : N_LARGE_T3;
+    if (n < 4) return 0;
+    int *L = (int*)malloc(n * sizeof(int));
+    if (!L) {
+        perror("Failed to allocate large array");
+        return 1;
+    }
+    // Parallel first-touch init with pseudo-random values in [0, 1000000), then plant each
+    // extremum twice: the reported index must be the first copy.
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < n; i++) L[i] = (int)(((unsigned long)i * 2654435761u) % 1000000u);
+    L[n / 3] = L[2 * (n / 3)] = -5;
+    L[n / 2] = L[n - 1] = 2000000;
+
+    double gb = n * (double)sizeof(int) / 1e9;
+    printf("\nVersion C on %ld elements (%.2f GB, %d threads):\n", n, gb, omp_get_max_threads());
+
+    int min_big = INT_MAX, max_big = INT_MIN;
+    double t0 = omp_get_wtime();
+    #pragma omp parallel for reduction(min: min_big) reduction(max: max_big)
+    for (long i = 0; i < n; i++) {
+        if (L[i] < min_big) min_big = L[i];
+        if (L[i] > max_big) max_big = L[i];
+    }
+    double time_big_red = omp_get_wtime() - t0;
+    printf("  Reduction clauses: Min = %d, Max = %d (no indices) | %f s, %.2f GB/s\n",
+           min_big, max_big, time_big_red, gb / time_big_red);
+
+    t0 = omp_get_wtime();
+    MinMax scalar = minMaxParallel(L, n, minMaxScalar);
+    double time_scalar = omp_get_wtime() - t0;
+    printf("  Fused scalar:      Min = %d at %ld, Max = %d at %ld | %f s, %.2f GB/s\n",
+           scalar.min, scalar.argmin, scalar.max, scalar.argmax, time_scalar, gb / time_scalar);
+
+    t0 = omp_get_wtime();
+    MinMax fused = minMaxParallel(L, n, kernel);
+    double time_fused = omp_get_wtime() - t0;
+    printf("  Fused %-6s       Min = %d at %ld, Max = %d at %ld | %f s, %.2f GB/s\n", kernel_name,
+           fused.min, fused.argmin, fused.max, fused.argmax, time_fused, gb / time_fused);
+
+    int ok = fused.min == -5 && fused.argmin == n / 3 && fused.max == 2000000 && fused.argmax == n / 2 &&
+             scalar.argmin == fused.argmin && scalar.argmax == fused.argmax;
+    printf("  Expected: Min = -5 at %ld, Max = 2000000 at %ld [%s]\n", n / 3, n / 2, ok ? "correct" : "WRONG");
+
+    free(L);
     return 0;
 }
 
@@ -242,6 +465,10 @@ int main() {
     }
 
     // Initialize matrices (simple initialization for verification)
+    // Done in parallel with the same static row split as the multiply loops: Linux places each
+    // page on the NUMA node of the thread that first writes it, so every thread's rows of A and C
+    // end up local to it instead of all on the main thread's node.
+    #pragma omp parallel for schedule(static)
     for (int i = 0; i < N_MAT; i++) {
         for (int j = 0; j < N_MAT; j++) {
             A[i * N_MAT + j] = 1; // A[i][j] = 1
@@ -250,6 +477,27 @@ int main() {
         }
     }
 
+    // --- 0. Pack B ---
+    // Store B transposed (Bt[j][k] = B[k][j]) once per multiply, so the inner k-loop
+    // streams both A and Bt with unit stride instead of walking down a column of B.
+    int *Bt = (int*)malloc(N_MAT * N_MAT * sizeof(int));
+    if (!Bt) {
+        perror("Failed to allocate memory");
+        return 1;
+    }
+
+    double start_time_pack = omp_get_wtime();
+
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < N_MAT; j++) {
+        for (int k = 0; k < N_MAT; k++) {
+            Bt[j * N_MAT + k] = B[k * N_MAT + j];
+        }
+    }
+
+    double time_spent_pack = omp_get_wtime() - start_time_pack;
+    printf("0. Packing Time (B transpose): %f seconds\n", time_spent_pack);
+
     // --- 1. Sequential Program ---
     double start_time_seq = omp_get_wtime();
 
@@ -257,19 +505,20 @@ int main() {
         for (int j = 0; j < N_MAT; j++) {
             int sum = 0;
             for (int k = 0; k < N_MAT; k++) {
-                sum += A[i * N_MAT + k] * B[k * N_MAT + j];
+                sum += A[i * N_MAT + k] * Bt[j * N_MAT + k];
             }
             C[i * N_MAT + j] = sum;
         }
     }
 
     double time_spent_seq = omp_get_wtime() - start_time_seq;
-    printf("1. Sequential Time: %f seconds\n", time_spent_seq);
+    printf("1. Sequential Time: %f seconds (%f s including packing)\n", time_spent_seq, time_spent_seq + time_spent_pack);
     // Print a verification element: C[0][0] should be Sum(B[k][0]) = N * 1 = 200
     printf("   Verification C[0][0]: %d\n", C[0]);
 
 
     // Reset C for parallel run
+    #pragma omp parallel for schedule(static)
     for (int i = 0; i < N_MAT * N_MAT; i++) C[i] = 0;
 
     // --- 2. Parallel Program (Run with 2, 4, 8 threads) ---
@@ -282,7 +531,7 @@ int main() {
         double start_time_par = omp_get_wtime();
 
         // Parallelize the outer two loops (distribute rows/columns)
-        #pragma omp parallel for
+        #pragma omp parallel for schedule(static)
         for (int i = 0; i < N_MAT; i++) { // Distribute rows of C (and A)
             for (int j = 0; j < N_MAT; j++) { // Distribute columns of C (and B)
                 
@@ -293,21 +542,148 @@ int main() {
                 // the spirit of the instruction is to show reduction usage.
                 #pragma omp parallel for reduction(+:sum)
                 for (int k = 0; k < N_MAT; k++) {
-                    sum += A[i * N_MAT + k] * B[k * N_MAT + j];
+                    sum += A[i * N_MAT + k] * Bt[j * N_MAT + k];
                 }
                 C[i * N_MAT + j] = sum;
             }
         }
 
         double time_spent_par = omp_get_wtime() - start_time_par;
-        printf("2. Parallel Time (%d threads): %f seconds\n", num_threads, time_spent_par);
+        printf("2. Parallel Time (%d threads): %f seconds (%f s including packing)\n",
+               num_threads, time_spent_par, time_spent_par + time_spent_pack);
     }
 
     printf("\nExpected Outcome: Parallel multiplication is significantly faster than sequential.\n");
     printf("This shows how OpenMP improves performance for computationally intensive tasks.\n");
 
-    free(A); free(B); free(C);
+    free(A); free(B); free(C); free(Bt);
     return 0;
 }
 
 
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <omp.h>
+#include <atomic>
+#include "atomic_ops.hpp" // fetch_min_cas, fetch_max_cas, fetch_update_cas (C++: compile with g++)
+
+#define N_T6 (1 << 20) // elements / increments per measurement
+
+int main() {
+    printf("--- TASK 6: Lock-Free Atomics vs Critical (Min/Max and Counter) ---\n");
+
+    int *A = (int*)malloc(N_T6 * sizeof(int));
+    if (!A) {
+        perror("Failed to allocate memory");
+        return 1;
+    }
+    for (int i = 0; i < N_T6; i++) A[i] = (int)(((unsigned)i * 2654435761u) % 1000000u);
+
+    int thread_counts[] = {2, 4, 8, 16, 32, 64};
+    printf("\nThroughput in million updates per second (%d per run):\n", N_T6);
+    printf("%8s | %12s %12s %12s | %12s %12s %12s %12s\n", "threads", "min/max crit", "min/max CAS",
+           "reduction", "count crit", "omp atomic", "fetch_add", "update(+1)");
+
+    for (int k = 0; k < 6; k++) {
+        int num_threads = thread_counts[k];
+        omp_set_num_threads(num_threads);
+        double t0, t[7];
+
+        // --- Min/Max, Version B style: every element enters the critical section ---
+        int min_crit = INT_MAX, max_crit = INT_MIN;
+        t0 = omp_get_wtime();
+        #pragma omp parallel for
+        for (int i = 0; i < N_T6; i++) {
+            #pragma omp critical
+            {
+                if (A[i] < min_crit) min_crit = A[i];
+                if (A[i] > max_crit) max_crit = A[i];
+            }
+        }
+        t[0] = omp_get_wtime() - t0;
+
+        // --- Min/Max with CAS loops: most elements exit after one plain load ---
+        std::atomic<int> min_cas(INT_MAX), max_cas(INT_MIN);
+        t0 = omp_get_wtime();
+        #pragma omp parallel for
+        for (int i = 0; i < N_T6; i++) {
+            fetch_min_cas(min_cas, A[i]);
+            fetch_max_cas(max_cas, A[i]);
+        }
+        t[1] = omp_get_wtime() - t0;
+
+        // --- Min/Max with reduction clauses (reference: no shared updates at all) ---
+        int min_red = INT_MAX, max_red = INT_MIN;
+        t0 = omp_get_wtime();
+        #pragma omp parallel for reduction(min: min_red) reduction(max: max_red)
+        for (int i = 0; i < N_T6; i++) {
+            if (A[i] < min_red) min_red = A[i];
+            if (A[i] > max_red) max_red = A[i];
+        }
+        t[2] = omp_get_wtime() - t0;
+
+        // --- Counter, Task 4 style: critical around every increment ---
+        int count_crit = 0;
+        t0 = omp_get_wtime();
+        #pragma omp parallel for
+        for (int i = 0; i < N_T6; i++) {
+            #pragma omp critical
+            count_crit++;
+        }
+        t[3] = omp_get_wtime() - t0;
+
+        // --- Counter with omp atomic, std::atomic fetch_add, and the generic CAS update ---
+        int count_omp = 0;
+        t0 = omp_get_wtime();
+        #pragma omp parallel for
+        for (int i = 0; i < N_T6; i++) {
+            #pragma omp atomic
+            count_omp++;
+        }
+        t[4] = omp_get_wtime() - t0;
+
+        std::atomic<int> count_add(0), count_upd(0);
+        t0 = omp_get_wtime();
+        #pragma omp parallel for
+        for (int i = 0; i < N_T6; i++) count_add.fetch_add(1, std::memory_order_relaxed);
+        t[5] = omp_get_wtime() - t0;
+
+        t0 = omp_get_wtime();
+        #pragma omp parallel for
+        for (int i = 0; i < N_T6; i++) fetch_update_cas(count_upd, [](int c) { return c + 1; });
+        t[6] = omp_get_wtime() - t0;
+
+        int ok = min_crit == min_cas && max_crit == max_cas && min_crit == min_red && max_crit == max_red &&
+                 count_crit == N_T6 && count_omp == N_T6 && count_add == N_T6 && count_upd == N_T6;
+        printf("%8d |", num_threads);
+        for (int c = 0; c < 7; c++) printf(" %12.1f%s", N_T6 / t[c] / 1e6, c == 2 ? " |" : "");
+        printf("%s\n", ok ? "" : "  WRONG RESULT");
+    }
+
+    printf("\nExpected Outcome: the CAS min/max approaches the reduction because it rarely writes;\n");
+    printf("every counter variant must write, but hardware atomics still avoid the critical lock.\n");
+
+    free(A);
+    return 0;
+}
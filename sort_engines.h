@@ -0,0 +1,270 @@
+// sort_engines.h - parallel sort engines for int keys, shared by the sorting programs.
+//
+//   radixSort(arr, n)                            parallel LSD radix sort, 32-bit int keys
+//   radixSortKeys(keys, n, flip)                 the same on raw 32-bit keys (flip 0 for unsigned)
+//   kWayMergeRange(src, from, to, k, out)        sequential k-way merge with a loser tree
+//   multiCoRank(src, bounds, k, target, split)   k-way merge path: split positions for `target`
+//   parallelKWayMerge(src, bounds, k, dst)       k-way merge, one output slice per thread
+//   upperBound / lowerBound                      binary searches on a sorted int range
+//
+// Header-only: the programs are single translation units, so the functions are static.
+// Compiles as C and as C++.
+#ifndef SORT_ENGINES_H
+#define SORT_ENGINES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <omp.h>
+
+// LSD radix sort: bits per digit pass.
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+// --- Parallel LSD radix sort for 32-bit keys ---
+// Four 8-bit digit passes, least significant first, over the raw key bits XOR flip: flip is
+// 0x80000000 for signed keys (so negative keys order before positive ones) and 0 for unsigned
+// ones. Each pass:
+//   1. every thread histograms its own static chunk (no shared counters),
+//   2. one thread turns the histograms into start offsets, digit-major then thread-minor,
+//   3. every thread scatters its chunk to its own offsets (stable, so earlier passes survive).
+// A pass whose digit is the same for every key is skipped.
+static void radixSortKeys(uint32_t arr[], long n, uint32_t flip) {
+    if (n < 2) return;
+
+    int nthreads = omp_get_max_threads();
+    uint32_t *buf = (uint32_t*)malloc(n * sizeof(uint32_t));
+    long *hist = (long*)malloc((size_t)nthreads * RADIX_BUCKETS * sizeof(long));
+    if (!buf || !hist) {
+        perror("Failed to allocate radix buffers");
+        exit(1);
+    }
+    uint32_t *src = arr, *dst = buf;
+
+    for (int shift = 0; shift < 32; shift += RADIX_BITS) {
+        int skip = 0;
+
+        #pragma omp parallel num_threads(nthreads)
+        {
+            int t = omp_get_thread_num(), team = omp_get_num_threads();
+            long begin = n * t / team, end = n * (t + 1) / team;
+            long *count = hist + (long)t * RADIX_BUCKETS;
+
+            // 1. Per-thread histogram
+            memset(count, 0, RADIX_BUCKETS * sizeof(long));
+            for (long i = begin; i < end; i++) {
+                count[((src[i] ^ flip) >> shift) & (RADIX_BUCKETS - 1)]++;
+            }
+            #pragma omp barrier
+
+            // 2. Exclusive prefix sum over (digit, thread)
+            #pragma omp single
+            {
+                long offset = 0;
+                for (int d = 0; d < RADIX_BUCKETS; d++) {
+                    long digit_total = 0;
+                    for (int u = 0; u < team; u++) {
+                        long c = hist[(long)u * RADIX_BUCKETS + d];
+                        hist[(long)u * RADIX_BUCKETS + d] = offset;
+                        offset += c;
+                        digit_total += c;
+                    }
+                    if (digit_total == n) skip = 1;
+                }
+            } // implicit barrier: offsets and skip are visible to the team
+
+            // 3. Scatter
+            if (!skip) {
+                for (long i = begin; i < end; i++) {
+                    int d = ((src[i] ^ flip) >> shift) & (RADIX_BUCKETS - 1);
+                    dst[count[d]++] = src[i];
+                }
+            }
+        }
+
+        if (!skip) {
+            uint32_t *tmp = src; src = dst; dst = tmp;
+        }
+    }
+
+    // An odd number of executed passes leaves the result in buf
+    if (src != arr) {
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < n; i++) arr[i] = src[i];
+    }
+    free(buf);
+    free(hist);
+}
+
+// 32-bit int keys.
+static void radixSort(int arr[], long n) {
+    radixSortKeys((uint32_t*)arr, n, 0x80000000u);
+}
+
+// --- K-way merge of sorted segments with a loser (tournament) tree ---
+// Segment r is src[bounds[r] .. bounds[r+1]); the merge reads src[pos[r] .. end[r]) of each.
+// Internal node i (1..k-1) stores the run that LOST the match played there and tree[0] holds the
+// overall winner, so replacing the winner replays a single leaf-to-root path: log2(k) compares
+// per output element. Equal keys go to the lower segment index, which keeps the merge stable.
+typedef struct {
+    int k;
+    int *tree;        // tree[0] = winner, tree[1..k-1] = losers
+    const int *src;
+    long *pos, *end;  // per-segment cursor and limit
+} LoserTree;
+
+// Does run a beat run b? Exhausted runs act as +infinity.
+static int ltLess(const LoserTree *lt, int a, int b) {
+    if (lt->pos[a] == lt->end[a]) return 0;
+    if (lt->pos[b] == lt->end[b]) return 1;
+    int va = lt->src[lt->pos[a]], vb = lt->src[lt->pos[b]];
+    return va < vb || (va == vb && a < b);
+}
+
+// Play the initial tournament bottom-up: leaves are nodes k..2k-1, node i plays 2i against 2i+1.
+static void ltBuild(LoserTree *lt, int *winners) {
+    int k = lt->k;
+    for (int r = 0; r < k; r++) winners[k + r] = r;
+    for (int node = k - 1; node >= 1; node--) {
+        int a = winners[2 * node], b = winners[2 * node + 1];
+        if (ltLess(lt, a, b)) {
+            winners[node] = a;
+            lt->tree[node] = b;
+        } else {
+            winners[node] = b;
+            lt->tree[node] = a;
+        }
+    }
+    lt->tree[0] = k > 1 ? winners[1] : 0;
+}
+
+// Emit the winner and replay its path: at each node the stored loser challenges the new candidate.
+static int ltPop(LoserTree *lt) {
+    int w = lt->tree[0];
+    int value = lt->src[lt->pos[w]++];
+    for (int node = (lt->k + w) / 2; node >= 1; node /= 2) {
+        if (ltLess(lt, lt->tree[node], w)) {
+            int t = lt->tree[node];
+            lt->tree[node] = w;
+            w = t;
+        }
+    }
+    lt->tree[0] = w;
+    return value;
+}
+
+// Merge src[from[r] .. to[r]) of all k segments into out (sequential, one loser tree).
+static void kWayMergeRange(const int src[], const long from[], const long to[], int k, int out[]) {
+    long total = 0;
+    for (int r = 0; r < k; r++) total += to[r] - from[r];
+    if (total == 0) return;
+
+    LoserTree lt;
+    lt.k = k;
+    lt.src = src;
+    lt.tree = (int*)malloc(3 * k * sizeof(int)); // k tree slots + 2k build slots
+    lt.pos = (long*)malloc(2 * k * sizeof(long));
+    if (!lt.tree || !lt.pos) {
+        perror("Failed to allocate loser tree");
+        exit(1);
+    }
+    lt.end = lt.pos + k;
+    memcpy(lt.pos, from, k * sizeof(long));
+    memcpy(lt.end, to, k * sizeof(long));
+
+    ltBuild(&lt, lt.tree + k);
+    for (long i = 0; i < total; i++) out[i] = ltPop(&lt);
+
+    free(lt.tree);
+    free(lt.pos);
+}
+
+// First index in src[lo..hi) whose value is > v (upper) or >= v (lower).
+static long upperBound(const int src[], long lo, long hi, int v) {
+    while (lo < hi) {
+        long mid = lo + (hi - lo) / 2;
+        if (src[mid] <= v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static long lowerBound(const int src[], long lo, long hi, int v) {
+    while (lo < hi) {
+        long mid = lo + (hi - lo) / 2;
+        if (src[mid] < v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Number of keys <= v across all segments.
+static long countLessEqual(const int src[], const long bounds[], int k, int v) {
+    long count = 0;
+    for (int r = 0; r < k; r++) count += upperBound(src, bounds[r], bounds[r + 1], v) - bounds[r];
+    return count;
+}
+
+// --- Multi-sequence co-ranking: split positions so the first `target` merged outputs are
+// exactly src[bounds[r] .. split[r]) of every segment ---
+// The target-th key v is found by binary-searching each segment for its smallest element whose
+// global rank reaches target (the minimum over segments is v). Everything < v goes left, and the
+// remaining slots are filled with keys == v from the lowest segments first, matching the tree.
+static void multiCoRank(const int src[], const long bounds[], int k, long target, long split[]) {
+    if (target <= 0) {
+        for (int r = 0; r < k; r++) split[r] = bounds[r];
+        return;
+    }
+
+    int found = 0, v = 0;
+    for (int r = 0; r < k; r++) {
+        long lo = bounds[r], hi = bounds[r + 1];
+        while (lo < hi) {
+            long mid = lo + (hi - lo) / 2;
+            if (countLessEqual(src, bounds, k, src[mid]) >= target) hi = mid;
+            else lo = mid + 1;
+        }
+        if (lo < bounds[r + 1] && (!found || src[lo] < v)) {
+            v = src[lo];
+            found = 1;
+        }
+    }
+
+    long remaining = target;
+    for (int r = 0; r < k; r++) {
+        split[r] = lowerBound(src, bounds[r], bounds[r + 1], v);
+        remaining -= split[r] - bounds[r];
+    }
+    for (int r = 0; r < k && remaining > 0; r++) {
+        long equal = upperBound(src, split[r], bounds[r + 1], v) - split[r];
+        long take = equal < remaining ? equal : remaining;
+        split[r] += take;
+        remaining -= take;
+    }
+}
+
+// --- Parallel k-way merge: each thread co-ranks its slice of the output and merges it alone ---
+// dst receives all bounds[k] - bounds[0] keys; the slices are independent, so no synchronisation.
+static void parallelKWayMerge(const int src[], const long bounds[], int k, int dst[]) {
+    long n = bounds[k] - bounds[0];
+
+    #pragma omp parallel
+    {
+        int t = omp_get_thread_num(), team = omp_get_num_threads();
+        long k0 = n * t / team, k1 = n * (t + 1) / team;
+        long *from = (long*)malloc(2 * k * sizeof(long));
+        if (!from) {
+            perror("Failed to allocate merge splits");
+            exit(1);
+        }
+        long *to = from + k;
+
+        multiCoRank(src, bounds, k, k0, from);
+        multiCoRank(src, bounds, k, k1, to);
+        kWayMergeRange(src, from, to, k, dst + k0);
+        free(from);
+    }
+}
+
+#endif // SORT_ENGINES_H